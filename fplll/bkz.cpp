@@ -29,8 +29,8 @@ FPLLL_BEGIN_NAMESPACE
 template <class FT>
 BKZReduction<FT>::BKZReduction(MatGSO<Integer, FT> &m, LLLReduction<Integer, FT> &lll_obj,
                                const BKZParam &param)
-    : status(RED_SUCCESS), nodes(0), param(param), m(m), lll_obj(lll_obj), algorithm(NULL),
-      cputime_start(0)
+    : status(RED_SUCCESS), nodes(0), param(param), m(m), lll_obj(lll_obj), enum_obj(m, evaluator),
+      algorithm(NULL), cputime_start(0)
 {
   for (num_rows = m.d; num_rows > 0 && m.b[num_rows - 1].is_zero(); num_rows--)
   {
@@ -40,7 +40,8 @@ BKZReduction<FT>::BKZReduction(MatGSO<Integer, FT> &m, LLLReduction<Integer, FT>
 
 template <class FT> BKZReduction<FT>::~BKZReduction() {}
 
-template <class FT> void BKZReduction<FT>::rerandomize_block(int min_row, int max_row, int density)
+template <class FT>
+void rerandomize_block(MatGSO<Integer, FT> &m, int min_row, int max_row, int density)
 {
   if (max_row - min_row < 2)
     return;
@@ -74,8 +75,11 @@ template <class FT> void BKZReduction<FT>::rerandomize_block(int min_row, int ma
     }
   }
   m.row_op_end(min_row, max_row);
+}
 
-  return;
+template <class FT> void BKZReduction<FT>::rerandomize_block(int min_row, int max_row, int density)
+{
+  fplll::rerandomize_block(m, min_row, max_row, density);
 }
 
 template <class FT>
@@ -301,7 +305,6 @@ bool BKZReduction<FT>::svp_reduction(int kappa, int block_size, const BKZParam &
     FPLLL_DEBUG_CHECK(pruning.metric == PRUNER_METRIC_PROBABILITY_OF_SHORTEST)
 
     evaluator.solutions.clear();
-    Enumeration<FT> enum_obj(m, evaluator);
     enum_obj.enumerate(kappa, kappa + block_size, max_dist, max_dist_expo, vector<FT>(),
                        vector<enumxt>(), pruning.coefficients, dual);
     nodes += enum_obj.get_nodes();
@@ -725,8 +728,11 @@ int bkz_reduction_f(IntMatrix &b, const BKZParam &param, int sel_ft, double lll_
     return RED_SUCCESS;
   if (sel_ft == FT_DOUBLE || sel_ft == FT_LONG_DOUBLE)
     gso_flags |= GSO_ROW_EXPO;
+  // the enumeration of each block copies it from the double shadow instead of converting it
+  gso_flags |= GSO_DOUBLE_SHADOW;
   MatGSO<Integer, FT> m_gso(b, u, u_inv, gso_flags);
   LLLReduction<Integer, FT> lll_obj(m_gso, lll_delta, LLL_DEF_ETA, LLL_DEFAULT);
+  lll_obj.set_threads(param.threads);
   BKZReduction<FT> bkz_obj(m_gso, lll_obj, param);
   bkz_obj.bkz();
   return bkz_obj.status;
@@ -842,26 +848,38 @@ int hkz_reduction(IntMatrix &b, int flags, FloatType float_type, int precision)
 
 template class BKZReduction<FP_NR<double>>;
 template class BKZAutoAbort<FP_NR<double>>;
+template void rerandomize_block(MatGSO<Integer, FP_NR<double>> &m, int min_row, int max_row,
+                                int density);
 
 #ifdef FPLLL_WITH_LONG_DOUBLE
 template class BKZReduction<FP_NR<long double>>;
 template class BKZAutoAbort<FP_NR<long double>>;
+template void rerandomize_block(MatGSO<Integer, FP_NR<long double>> &m, int min_row, int max_row,
+                                int density);
 #endif
 
 #ifdef FPLLL_WITH_DPE
 template class BKZReduction<FP_NR<dpe_t>>;
 template class BKZAutoAbort<FP_NR<dpe_t>>;
+template void rerandomize_block(MatGSO<Integer, FP_NR<dpe_t>> &m, int min_row, int max_row,
+                                int density);
 #endif
 
 #ifdef FPLLL_WITH_QD
 template class BKZReduction<FP_NR<dd_real>>;
 template class BKZAutoAbort<FP_NR<dd_real>>;
+template void rerandomize_block(MatGSO<Integer, FP_NR<dd_real>> &m, int min_row, int max_row,
+                                int density);
 
 template class BKZReduction<FP_NR<qd_real>>;
 template class BKZAutoAbort<FP_NR<qd_real>>;
+template void rerandomize_block(MatGSO<Integer, FP_NR<qd_real>> &m, int min_row, int max_row,
+                                int density);
 #endif
 
 template class BKZReduction<FP_NR<mpfr_t>>;
 template class BKZAutoAbort<FP_NR<mpfr_t>>;
+template void rerandomize_block(MatGSO<Integer, FP_NR<mpfr_t>> &m, int min_row, int max_row,
+                                int density);
 
 FPLLL_END_NAMESPACE
@@ -52,6 +52,14 @@ private:
   int start_row;
 };
 
+/**
+   @brief Rerandomize the rows [min_row, max_row) of m with the random generator of RandGen, see
+   BKZReduction::rerandomize_block. The rows of m must be known to m (e.g. after update_gso()),
+   the block is not LLL-reduced afterwards.
+*/
+template <class FT>
+void rerandomize_block(MatGSO<Integer, FT> &m, int min_row, int max_row, int density);
+
 /* The matrix must be LLL-reduced */
 template <class FT> class BKZReduction
 {
@@ -197,7 +205,9 @@ private:
   int num_rows;
   MatGSO<Integer, FT> &m;
   LLLReduction<Integer, FT> &lll_obj;
-  FastEvaluator<FT> evaluator;
+  PooledEvaluator<FT> evaluator;
+  // Kept for all blocks, it reuses the dual GSO of the blocks which have not changed
+  Enumeration<FT> enum_obj;
   FT delta;
 
   const char *algorithm;
@@ -128,7 +128,7 @@ public:
         max_loops(max_loops), max_time(max_time), auto_abort_scale(auto_abort_scale),
         auto_abort_max_no_dec(auto_abort_max_no_dec), gh_factor(gh_factor),
         dump_gso_filename("gso.log"), min_success_probability(min_success_probability),
-        rerandomization_density(rerandomization_density)
+        rerandomization_density(rerandomization_density), threads(1)
   {
 
     // we create dummy strategies
@@ -185,6 +185,10 @@ public:
   /** density of rerandomization operation when using extreme pruning **/
 
   int rerandomization_density;
+
+  /** threads of the size reductions of bkz_reduction (see LLLReduction::set_threads) **/
+
+  unsigned int threads;
 };
 
 /**
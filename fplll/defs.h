@@ -138,6 +138,10 @@ const double LLL_DEF_DELTA        = 0.99;
 const double LLL_DEF_ETA          = 0.51;
 const double LLL_DEF_EPSILON      = 0.01;
 const int SIZE_RED_FAILURE_THRESH = 5;
+const int SIZE_RED_PARALLEL_ROWS  = 16;
+
+/* Rows of Matrix start on a multiple of MATRIX_ALIGNMENT bytes (size of a cache line) */
+const int MATRIX_ALIGNMENT = 64;
 
 enum RedStatus
 {
@@ -220,7 +224,9 @@ enum SVPFlags
   SVP_DEFAULT      = 0,
   SVP_VERBOSE      = 1,
   SVP_OVERRIDE_BND = 2,
-  SVP_DUAL         = 4
+  SVP_DUAL         = 4,
+  SVP_RESUME       = 8,
+  SVP_BATCH_VERIFY = 16
 };
 
 enum CVPFlags
@@ -17,45 +17,283 @@
    along with fplll. If not, see <http://www.gnu.org/licenses/>. */
 
 #include "enumerate.h"
+#include <cstdio>
+#include <fstream>
+#include <thread>
 
 FPLLL_BEGIN_NAMESPACE
 
-template <typename FT> void EnumerationDyn<FT>::reset(enumf cur_dist, int cur_depth)
+/* CVP reset below level cur_depth: the closest vector to the target with the coordinates x of the
+   levels above is enumerated again with the bound sum(r_ii, i <= cur_depth), by a reset context
+   which reuses the enumeration data of this object. */
+template <typename FT, int N> void EnumerationDyn<FT, N>::reset(enumf cur_dist, int cur_depth)
 {
   // FPLLL_TRACE("Reset level " << cur_depth);
-  int new_dim = cur_depth + 1;
+  if (reset_state != nullptr)
+  {
+    apply_reset_results();
+    lower_reset_bound(*reset_state, partdistbounds[0]);
+    std::lock_guard<std::mutex> lock(reset_state->mutex);
+    if (reset_state->jobs.size() < size_t(ENUM_RESET_JOBS_PER_THREAD) * (_threads - 1))
+    {
+      reset_state->jobs.push_back(
+          ResetJob{vector<enumxt>(&x[cur_depth + 1], &x[0] + d), cur_depth, cur_dist});
+      reset_state->wakeup.notify_one();
+      return;
+    }
+  }
+
+  if (reset_contexts.empty())
+    reset_contexts.emplace_back(new ResetContext(_gso, _max_indices));
+  if (!reset_contexts_loaded)
+  {
+    reset_contexts[0]->enumobj.load_reset_data(*this);
+    reset_contexts_loaded = true;
+  }
+
+  reset_job.prefix.assign(&x[cur_depth + 1], &x[0] + d);
+  reset_job.depth = cur_depth;
+  reset_job.dist  = cur_dist;
+  enumf bound     = partdistbounds[0];
+  if (reset_state != nullptr)
+    bound = min(bound, reset_state->bound.load());
+  if (reset_contexts[0]->enumobj.enumerate_reset(reset_job, bound, reset_result) &&
+      reset_result.dist < partdistbounds[0])
+  {
+    // FPLLL_TRACE("Recovering sub-solution at level: " << cur_depth <<" soldist: " << sol_dist);
+    for (int i = 0; i <= cur_depth; ++i)
+      x[i] = reset_result.x[i];
+    process_solution(reset_result.dist);
+  }
+}
+
+/* Saves the target and the bounds of the CVP resets of the enumeration being started, before
+   the coordinates of the subtree are subtracted from center_partsum. */
+template <typename FT, int N> void EnumerationDyn<FT, N>::prepare_resets()
+{
+  std::copy(center_partsum.begin(), center_partsum.begin() + d, reset_center.begin());
+  enumf radius = 0.0;
+  for (int i = 0; i < d; ++i)
+  {
+    radius += rdiag[i];
+    reset_radius[i] = radius;
+  }
+  reset_contexts_loaded = false;
+}
+
+/* Copies the enumeration data of `master` to enumerate its reset subproblems. */
+template <typename FT, int N>
+void EnumerationDyn<FT, N>::load_reset_data(const EnumerationDyn<FT, N> &master)
+{
+  d              = master.d;
+  dual           = false;
+  resetflag      = true;
+  _max_indices   = master._max_indices;
+  pruning_bounds = master.pruning_bounds;
+  rdiag          = master.rdiag;
+  subsoldists    = master.rdiag;
+  reset_center   = master.reset_center;
+  reset_radius   = master.reset_radius;
+  stop_flag      = master.stop_flag;
+  for (int i = 0; i < d; ++i)
+    std::copy(master.mut[i], master.mut[i] + d, mut[i]);
+  reset_contexts_loaded = false;
+}
 
-  vector<enumxt> partial_sol(d - cur_depth - 1);
-  for (int i                       = cur_depth + 1; i < d; ++i)
-    partial_sol[i - cur_depth - 1] = x[i];
+/* Enumerates the closest vector of the reset subproblem `job` whose distance to the target is
+   below `bound`: farther vectors could not become solutions of the enumeration which resets.
+   Returns false if there is none. */
+template <typename FT, int N>
+bool EnumerationDyn<FT, N>::enumerate_reset(const ResetJob &job, enumf bound, ResetResult &result)
+{
+  reset_offset = job.dist;
+  maxdist      = min(reset_radius[job.depth], bound - job.dist);
+  if (maxdist <= 0.0)
+    return false;
+  reset_depth = _max_indices[job.depth];
+
+  _evaluator->solutions.clear();
+  _evaluator->set_normexp(0);
+  std::copy(reset_center.begin(), reset_center.begin() + d, center_partsum.begin());
+  prepare_enumeration(job.prefix, false, true);
+  do_enumerate();
+  _evaluator->sync_solutions();
+  if (_evaluator->empty())
+    return false;
 
-  FT new_dist = 0.0;
-  for (int i = 0; i < new_dim; i++)
-    new_dist.add(new_dist, _gso.get_r_exp(i, i));
+  auto best   = _evaluator->begin();
+  result.dist = best->first.get_d() + job.dist;
+  result.x.resize(d);
+  for (int i = 0; i < d; ++i)
+    result.x[i] = best->second[i].get_d();
+  return true;
+}
 
-  FastEvaluator<FT> new_evaluator;
-  Enumeration<FT> enumobj(_gso, new_evaluator, _max_indices);
-  enumobj.enumerate(0, d, new_dist, 0, target, partial_sol, pruning_bounds, false, true);
+/* Parallel CVP enumeration with resets: the calling thread enumerates the levels above the resets
+   and hands over the reset subproblems to the worker threads, each with its own reset context.
+   The solutions of the subproblems are passed to the evaluator by the calling thread, before its
+   next reset and at the end. The distance of the closest vector found so far by any thread is
+   shared, it bounds the subproblems being enumerated (see poll()). */
+template <typename FT, int N> void EnumerationDyn<FT, N>::enumerate_reset_parallel()
+{
+  ResetState state;
+  state.bound = maxdist;
+  state.done  = false;
+  reset_state = &state;
 
-  if (!new_evaluator.empty())
+  while (reset_contexts.size() < _threads)
+    reset_contexts.emplace_back(new ResetContext(_gso, _max_indices));
+  for (unsigned int i = 0; i < _threads; ++i)
+    reset_contexts[i]->enumobj.load_reset_data(*this);
+  reset_contexts_loaded = true;
+
+  unsigned int prec = FT::get_prec();
+  vector<std::thread> threads;
+  for (unsigned int i = 1; i < _threads; ++i)
+    threads.emplace_back(&EnumerationDyn<FT, N>::run_resets, &reset_contexts[i]->enumobj,
+                         std::ref(state), prec);
+
+  // the calling thread enumerates subproblems too while the queue is full
+  EnumerationDyn<FT, N> &context = reset_contexts[0]->enumobj;
+  context.reset_worker           = &state;
+  context.polling                = true;
+  save_rounding();
+  prepare_enumeration(vector<enumxt>(), false, false);
+  do_enumerate();
   {
-    FT sol_dist2 = new_evaluator.begin()->first;
-    sol_dist2.mul_2si(sol_dist2, -new_evaluator.normExp);
-    enumf sol_dist = sol_dist2.get_d();
-    // FPLLL_TRACE("Recovering sub-solution at level: " << cur_depth <<" soldist: " << sol_dist);
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.done = true;
+  }
+  state.wakeup.notify_all();
+  for (auto &thread : threads)
+    thread.join();
+  apply_reset_results();
+  restore_rounding();
+  context.polling      = false;
+  context.reset_worker = nullptr;
+  reset_state          = nullptr;
+}
 
-    if (sol_dist + cur_dist < partdistbounds[0])
+/* Worker thread of a parallel CVP enumeration: enumerates the reset subproblems of the queue until
+   the calling thread is finished. */
+template <typename FT, int N>
+void EnumerationDyn<FT, N>::run_resets(ResetState &state, unsigned int prec)
+{
+  FT::set_prec(prec);
+  save_rounding();
+  reset_worker = &state;
+  polling      = true;
+  ResetJob job;
+  while (true)
+  {
     {
-      // FPLLL_TRACE("Saving it.");
-      for (int i = 0; i < new_dim; ++i)
-        x[i]     = new_evaluator.begin()->second[i].get_d();
-      process_solution(sol_dist + cur_dist);
+      std::unique_lock<std::mutex> lock(state.mutex);
+      while (state.jobs.empty() && !state.done)
+        state.wakeup.wait(lock);
+      if (state.jobs.empty())
+        break;
+      job = std::move(state.jobs.front());
+      state.jobs.pop_front();
+    }
+    if (enumerate_reset(job, state.bound.load(), reset_result))
+    {
+      std::lock_guard<std::mutex> lock(state.mutex);
+      state.results.push_back(reset_result);
     }
   }
+  polling      = false;
+  reset_worker = nullptr;
+  restore_rounding();
 }
 
-template <typename FT>
-void EnumerationDyn<FT>::enumerate(int first, int last, FT &fmaxdist, long fmaxdistexpo,
+/* Lowers the shared bound of a parallel CVP enumeration to `bound` if it is smaller. */
+template <typename FT, int N>
+void EnumerationDyn<FT, N>::lower_reset_bound(ResetState &state, enumf bound)
+{
+  enumf current = state.bound.load();
+  while (bound < current && !state.bound.compare_exchange_weak(current, bound))
+  {
+  }
+}
+
+/* Passes the solutions of the reset subproblems finished by the worker threads to the evaluator,
+   if they are still below the bound. */
+template <typename FT, int N> void EnumerationDyn<FT, N>::apply_reset_results()
+{
+  vector<ResetResult> results;
+  {
+    std::lock_guard<std::mutex> lock(reset_state->mutex);
+    results.swap(reset_state->results);
+  }
+  for (const ResetResult &result : results)
+  {
+    if (result.dist >= partdistbounds[0])
+      continue;
+    ++nr_solutions;
+    _evaluator->eval_raw_sol(&result.x[0], d, result.dist, maxdist);
+    set_bounds();
+  }
+}
+
+/* The dual GSO of the block is kept between enumerations: the rows of the block before the first
+   one modified since the last dual enumeration of this block keep their GSO, only the rows from
+   it on are converted again, and the cached rdiag rescaled if normexp has changed. A block of
+   another dimension starting at the same row replaces it. */
+template <typename FT, int N> void EnumerationDyn<FT, N>::load_dual_gso(int first, long normexp)
+{
+  DualBlock &block = dual_blocks[first];
+  if (block.stamps.size() != (size_t)d)
+  {
+    block.mut.resize(d * d);
+    block.rdiag.resize(d);
+    block.stamps.assign(d, -1);
+    block.normexp = normexp;
+  }
+
+  int k = 0;
+  while (k < d && _gso.get_row_op_stamp(first + k, first + k + 1) == block.stamps[k])
+    ++k;
+  if (normexp != block.normexp)
+  {
+    for (int i = 0; i < k; ++i)
+      block.rdiag[d - i - 1] = ldexp(block.rdiag[d - i - 1], normexp - block.normexp);
+    block.normexp = normexp;
+  }
+
+  FT fr, fmu;
+  long rexpo;
+  for (int i = k; i < d; ++i)
+  {
+    block.stamps[i] = _gso.get_row_op_stamp(first + i, first + i + 1);
+    if (_gso.enable_double_shadow)
+    {
+      enumf r                = _gso.get_double_shadow_r(i + first, rexpo);
+      block.rdiag[d - i - 1] = enumf(1.0) / ldexp(r, rexpo - normexp);
+      for (int j = 0; j < i; ++j)
+        block.mut[(d - i - 1) * d + d - j - 1] = -_gso.get_double_shadow_mu(j + first)[i + first];
+    }
+    else
+    {
+      fr = _gso.get_r_exp(i + first, i + first, rexpo);
+      fr.mul_2si(fr, rexpo - normexp);
+      block.rdiag[d - i - 1] = enumf(1.0) / fr.get_d();
+      for (int j = 0; j < i; ++j)
+      {
+        _gso.get_mu(fmu, i + first, j + first);
+        block.mut[(d - i - 1) * d + d - j - 1] = -fmu.get_d();
+      }
+    }
+  }
+
+  for (int i = 0; i < d; ++i)
+  {
+    rdiag[i] = block.rdiag[i];
+    std::copy(block.mut.begin() + i * d + i + 1, block.mut.begin() + (i + 1) * d, mut[i] + i + 1);
+  }
+}
+
+template <typename FT, int N>
+void EnumerationDyn<FT, N>::enumerate(int first, int last, FT &fmaxdist, long fmaxdistexpo,
                                    const vector<FT> &target_coord, const vector<enumxt> &subtree,
                                    const vector<enumf> &pruning, bool _dual, bool subtree_reset)
 {
@@ -66,7 +304,6 @@ void EnumerationDyn<FT>::enumerate(int first, int last, FT &fmaxdist, long fmaxd
   if (last == -1)
     last = _gso.d;
   d      = last - first;
-  fx.resize(d);
   FPLLL_CHECK(d < maxdim, "enumerate: dimension is too high");
   FPLLL_CHECK((solvingsvp || !dual), "CVP for dual not implemented! What does that even mean? ");
   FPLLL_CHECK((subtree.empty() || !dual), "Subtree enumeration for dual not implemented!");
@@ -86,33 +323,39 @@ void EnumerationDyn<FT>::enumerate(int first, int last, FT &fmaxdist, long fmaxd
       center_partsum[i] = target_coord[i + first].get_d();
   }
 
-  FT fr, fmu, fmaxdistnorm;
+  FT fr, fmu;
   long rexpo, normexp = -1;
-  for (int i = 0; i < d; ++i)
+  if (_gso.enable_double_shadow)
   {
-    fr      = _gso.get_r_exp(i + first, i + first, rexpo);
-    normexp = max(normexp, rexpo + fr.exponent());
+    _gso.update_double_shadow(first, last);
+    for (int i = 0; i < d; ++i)
+    {
+      _gso.get_double_shadow_r(i + first, rexpo);
+      normexp = max(normexp, rexpo);
+    }
   }
-  fmaxdistnorm.mul_2si(fmaxdist, dual ? normexp - fmaxdistexpo : fmaxdistexpo - normexp);
-  maxdist = fmaxdistnorm.get_d(GMP_RNDU);
-
-  _evaluator.set_normexp(normexp);
-
-  if (dual)
+  else
   {
     for (int i = 0; i < d; ++i)
     {
-      fr = _gso.get_r_exp(i + first, i + first, rexpo);
-      fr.mul_2si(fr, rexpo - normexp);
-      rdiag[d - i - 1] = enumf(1.0) / fr.get_d();
+      fr      = _gso.get_r_exp(i + first, i + first, rexpo);
+      normexp = max(normexp, rexpo + fr.exponent());
     }
+  }
+
+  if (dual)
+  {
+    load_dual_gso(first, normexp);
+  }
+  else if (_gso.enable_double_shadow)
+  {
+    // the rows of mut are the columns of mu, stored contiguously in the shadow
     for (int i = 0; i < d; ++i)
     {
-      for (int j = i + 1; j < d; ++j)
-      {
-        _gso.get_mu(fmu, j + first, i + first);
-        mut[d - j - 1][d - i - 1] = -fmu.get_d();
-      }
+      enumf r              = _gso.get_double_shadow_r(i + first, rexpo);
+      rdiag[i]             = ldexp(r, rexpo - normexp);
+      const double *mu_col = _gso.get_double_shadow_mu(i + first);
+      std::copy(mu_col + first + i + 1, mu_col + last, mut[i] + i + 1);
     }
   }
   else
@@ -133,32 +376,130 @@ void EnumerationDyn<FT>::enumerate(int first, int last, FT &fmaxdist, long fmaxd
     }
   }
 
-  subsoldists = rdiag;
+  enumerate_converted(fmaxdist, fmaxdistexpo, normexp, subtree, solvingsvp, subtree_reset);
+}
 
-  save_rounding();
-  prepare_enumeration(subtree, solvingsvp, subtree_reset);
-  do_enumerate();
-  restore_rounding();
+template <typename FT, int N>
+void EnumerationDyn<FT, N>::enumerate(const EnumerationGSOData &gso_data, EnumerationJob<FT> &job)
+{
+  _evaluator     = &job.evaluator;
+  dual           = job.dual;
+  pruning_bounds = job.pruning;
+  target.clear();
+  d = job.last - job.first;
+  FPLLL_CHECK(d < maxdim, "enumerate: dimension is too high");
+  bool solvingsvp = job.target.empty();
+  FPLLL_CHECK(solvingsvp || (!dual && int(job.target.size()) == d),
+              "enumerate: invalid CVP job (dual, or target of another dimension)");
+
+  _max_indices = job.max_indices;
+  resetflag    = !_max_indices.empty();
+  if (resetflag)
+    reset_depth = _max_indices[d - 1];
+  if (solvingsvp)
+    fill(center_partsum.begin(), center_partsum.begin() + d, 0.0);
+  else
+    std::copy(job.target.begin(), job.target.end(), center_partsum.begin());
+
+  int first    = job.first - gso_data.first;
+  long normexp = -1;
+  for (int i = 0; i < d; ++i)
+    normexp = max(normexp, gso_data.r_expo[first + i]);
+
+  for (int i = 0; i < d; ++i)
+  {
+    enumf r = ldexp(gso_data.r_mant[first + i], gso_data.r_expo[first + i] - normexp);
+    if (dual)
+      rdiag[d - i - 1] = enumf(1.0) / r;
+    else
+      rdiag[i] = r;
+  }
+  for (int i = 0; i < d; ++i)
+  {
+    for (int j = i + 1; j < d; ++j)
+    {
+      if (dual)
+        mut[d - j - 1][d - i - 1] = -gso_data.get_mu(job.first + j, job.first + i);
+      else
+        mut[i][j] = gso_data.get_mu(job.first + j, job.first + i);
+    }
+  }
+
+  enumerate_converted(job.maxdist, job.maxdistexpo, normexp, vector<enumxt>(), solvingsvp, false);
+  job.nodes = this->get_nodes();
+}
+
+/* Second part of enumerate(), once the GSO data of the block has been converted to enumf and
+   normalized by 2^normexp. */
+template <typename FT, int N>
+void EnumerationDyn<FT, N>::enumerate_converted(FT &fmaxdist, long fmaxdistexpo, long normexp,
+                                                const vector<enumxt> &subtree, bool solvingsvp,
+                                                bool subtree_reset)
+{
+  FT fmaxdistnorm;
+  fmaxdistnorm.mul_2si(fmaxdist, dual ? normexp - fmaxdistexpo : fmaxdistexpo - normexp);
+  maxdist = fmaxdistnorm.get_d(GMP_RNDU);
+
+  _evaluator->set_normexp(normexp);
+
+  subsoldists     = rdiag;
+  nr_solutions    = 0;
+  nr_subsolutions = 0;
+  if (resetflag)
+    prepare_resets();
+
+  if (solvingsvp && !dual && !resetflag && !_evaluator->findsubsols)
+    float_levels = min(float_cutoff, d);
+  else
+    float_levels = 0;
+  prepare_float_levels();
+
+  if (!checkpoint_file.empty() && solvingsvp && !dual && subtree.empty() && !resetflag &&
+      !_evaluator->findsubsols)
+  {
+    enumerate_checkpointed(normexp);
+  }
+  else if (_threads > 1 && solvingsvp && !dual && subtree.empty() && !resetflag &&
+           d > ENUM_PARALLEL_MIN_LEVELS)
+  {
+    enumerate_parallel();
+  }
+  else if (_threads > 1 && !solvingsvp && subtree.empty() && resetflag &&
+           !_evaluator->findsubsols)
+  {
+    enumerate_reset_parallel();
+  }
+  else
+  {
+    save_rounding();
+    prepare_enumeration(subtree, solvingsvp, subtree_reset);
+    polling = stop_flag != nullptr;
+    do_enumerate();
+    polling = false;
+    restore_rounding();
+  }
 
   fmaxdistnorm = maxdist;  // Exact
 
   fmaxdist.mul_2si(fmaxdistnorm, dual ? fmaxdistexpo - normexp : normexp - fmaxdistexpo);
 
-  if (dual && !_evaluator.empty())
+  _evaluator->sync_solutions();
+  if (dual && !_evaluator->empty())
   {
-    for (auto it = _evaluator.begin(), itend = _evaluator.end(); it != itend; ++it)
+    for (auto it = _evaluator->begin(), itend = _evaluator->end(); it != itend; ++it)
       reverse_by_swap(it->second, 0, d - 1);
   }
 }
 
-template <typename FT>
-void EnumerationDyn<FT>::prepare_enumeration(const vector<enumxt> &subtree, bool solvingsvp,
+template <typename FT, int N>
+void EnumerationDyn<FT, N>::prepare_enumeration(const vector<enumxt> &subtree, bool solvingsvp,
                                              bool subtree_reset)
 {
   is_svp = solvingsvp;
 
   enumf newdist = 0.0;
   k_end         = d - subtree.size();
+  cut_level     = k_end;
   for (k = d - 1; k >= 0 && newdist <= maxdist; --k)
   {
     enumf newcenter = center_partsum[k];
@@ -208,7 +549,7 @@ void EnumerationDyn<FT>::prepare_enumeration(const vector<enumxt> &subtree, bool
   ++k;
 }
 
-template <typename FT> void EnumerationDyn<FT>::set_bounds()
+template <typename FT, int N> void EnumerationDyn<FT, N>::set_bounds()
 {
   if (pruning_bounds.empty())
   {
@@ -219,69 +560,746 @@ template <typename FT> void EnumerationDyn<FT>::set_bounds()
     for (int i          = 0; i < d; ++i)
       partdistbounds[i] = pruning_bounds[i] * maxdist;
   }
+  // the centers of these levels are inexact, see set_float_levels()
+  for (int i = 0; i < float_levels; ++i)
+    partdistbounds[i] *= 1.0 + ENUM_FLOAT_SLACK;
+  // no sibling passes the bound at levels given away to other threads
+  for (int i = cut_level; i < k_end; ++i)
+    partdistbounds[i] = -1.0;
 }
 
-template <typename FT> void EnumerationDyn<FT>::process_solution(enumf newmaxdist)
+/* Squared norm of the solution x of a primal SVP enumeration, computed again in double for the
+   mixed-precision enumeration. */
+template <typename FT, int N> enumf EnumerationDyn<FT, N>::solution_dist() const
 {
-  FPLLL_TRACE("Sol dist: " << newmaxdist << " (nodes:" << nodes << ")");
-  for (int j = 0; j < d; ++j)
-    fx[j]    = x[j];
-  _evaluator.eval_sol(fx, newmaxdist, maxdist);
+  enumf dist = 0.0;
+  for (int i = 0; i < d; ++i)
+  {
+    enumf c = 0.0;
+    for (int j = i + 1; j < d; ++j)
+      c -= x[j] * mut[i][j];
+    dist += (x[i] - c) * (x[i] - c) * rdiag[i];
+  }
+  return dist;
+}
+
+template <typename FT, int N> void EnumerationDyn<FT, N>::process_solution(enumf newmaxdist)
+{
+  if (float_levels > 0)
+  {
+    newmaxdist = solution_dist();
+    if (!(newmaxdist <= (pruning_bounds.empty() ? 1.0 : pruning_bounds[0]) * maxdist))
+      return;
+  }
+  FPLLL_TRACE("Sol dist: " << newmaxdist << " (nodes:" << this->get_nodes() << ")");
+  ++nr_solutions;
+  _evaluator->eval_raw_sol(&x[0], d, newmaxdist, maxdist);
+  if (shared != nullptr)
+    update_shared_maxdist();
+  if (reset_worker != nullptr)
+    lower_reset_bound(*reset_worker, reset_offset + newmaxdist);
 
   set_bounds();
 }
 
-template <typename FT> void EnumerationDyn<FT>::process_subsolution(int offset, enumf newdist)
+template <typename FT, int N>
+void EnumerationDyn<FT, N>::process_subsolution(int offset, enumf newdist)
 {
-  for (int j = 0; j < offset; ++j)
-    fx[j]    = 0.0;
-  for (int j = offset; j < d; ++j)
-    fx[j]    = x[j];
-  _evaluator.eval_sub_sol(offset, fx, newdist);
+  ++nr_subsolutions;
+  _evaluator->eval_raw_sub_sol(offset, &x[0], d, newdist);
 }
 
-template <typename FT> void EnumerationDyn<FT>::do_enumerate()
+template <typename FT, int N> void EnumerationDyn<FT, N>::do_enumerate(bool walk_path)
 {
-  nodes = 0;
+  nodes.fill(0);
 
   set_bounds();
 
-  if (dual && _evaluator.findsubsols && !resetflag)
-    enumerate_loop<true, true, false>();
-  else if (!dual && _evaluator.findsubsols && !resetflag)
-    enumerate_loop<false, true, false>();
-  else if (dual && !_evaluator.findsubsols && !resetflag)
-    enumerate_loop<true, false, false>();
-  else if (!dual && !_evaluator.findsubsols && !resetflag)
-    enumerate_loop<false, false, false>();
-  else if (!dual && _evaluator.findsubsols && resetflag)
-    enumerate_loop<false, true, true>();
-  else if (!dual && !_evaluator.findsubsols && resetflag)
-    enumerate_loop<false, false, true>();
+  // the kernel starts by walking again the path from level k_end - 1 down to level k set up by
+  // prepare_enumeration(), as long as its nodes pass the bounds: these nodes are not counted
+  for (int i = k_end - 1; walk_path && i >= k; --i)
+  {
+    enumf alphai = i == k_end - 1 ? x[i] - center[i] : alpha[i];
+    if (!(partdist[i] + alphai * alphai * rdiag[i] <= partdistbounds[i]))
+      break;
+    --nodes[this->node_level(i)];
+    if (resetflag && i < reset_depth)
+      break;
+  }
+
+  if (dual && _evaluator->findsubsols && !resetflag)
+    this->template enumerate_loop<true, true, false, false>();
+  else if (!dual && _evaluator->findsubsols && !resetflag)
+    this->template enumerate_loop<false, true, false, false>();
+  else if (dual && !_evaluator->findsubsols && !resetflag)
+    this->template enumerate_loop<true, false, false, false>();
+  else if (!dual && !_evaluator->findsubsols && !resetflag && float_levels > 0)
+    this->template enumerate_loop<false, false, false, true>();
+  else if (!dual && !_evaluator->findsubsols && !resetflag)
+    this->template enumerate_loop<false, false, false, false>();
+  else if (!dual && _evaluator->findsubsols && resetflag)
+    this->template enumerate_loop<false, true, true, false>();
+  else if (!dual && !_evaluator->findsubsols && resetflag)
+    this->template enumerate_loop<false, false, true, false>();
 }
 
-template class Enumeration<FP_NR<double>>;
-template class EnumerationDyn<FP_NR<double>>;
+/* Publishes maxdist to the other threads of a parallel enumeration and adopts their bound if it
+   is smaller. */
+template <typename FT, int N> void EnumerationDyn<FT, N>::update_shared_maxdist()
+{
+  enumf bound = shared->maxdist.load();
+  while (maxdist < bound && !shared->maxdist.compare_exchange_weak(bound, maxdist))
+  {
+  }
+  maxdist = min(maxdist, bound);
+}
+
+/* Parallel SVP enumeration.
+   The top levels of the tree are enumerated by the calling thread and each node at the lowest of
+   these levels is the root of a subtree. The subtrees are taken from a common queue by the worker
+   threads, each of them with its own copy of the enumeration data. When the queue is empty, the
+   busy threads split their remaining work with the idle ones (see poll()). All threads share the
+   enumeration bound: it is published after each solution and read again before each subtree. */
+template <typename FT, int N> void EnumerationDyn<FT, N>::enumerate_parallel()
+{
+  SharedState state;
+  state.maxdist = maxdist;
+  state.idle    = 0;
+  state.threads = _threads;
+  state.done    = false;
+  shared        = &state;
+
+  save_rounding();
+  k_end     = d;
+  cut_level = d;
+  set_bounds();
+  size_t nr_subtrees = size_t(ENUM_PARALLEL_SUBTREES_PER_THREAD) * _threads;
+  for (int levels = 1;
+       levels <= d - ENUM_PARALLEL_MIN_LEVELS && state.subtrees.size() < nr_subtrees; ++levels)
+    split_subtrees(levels, state.subtrees);
+  restore_rounding();
+  uint64_t split_nodes = this->get_nodes();
+
+  // the calling thread is one of the workers, which are given the evaluator of this enumeration
+  unsigned int prec = FT::get_prec();
+  std::mutex evaluator_mutex;
+  vector<std::unique_ptr<SynchronizedEvaluator<FT>>> evaluators;
+  vector<std::thread> threads;
+  while (workers.size() < _threads)
+    workers.emplace_back(new EnumerationDyn<FT, N>(_gso, *_evaluator));
+  for (unsigned int i = 0; i < _threads; ++i)
+  {
+    if (_evaluator->is_thread_safe())
+    {
+      workers[i]->_evaluator = _evaluator;
+      continue;
+    }
+    evaluators.emplace_back(new SynchronizedEvaluator<FT>(*_evaluator, evaluator_mutex));
+    workers[i]->_evaluator = evaluators.back().get();
+  }
+  for (unsigned int i = 1; i < _threads; ++i)
+    threads.emplace_back(&EnumerationDyn<FT, N>::enumerate_subtrees, workers[i].get(),
+                         std::cref(*this), prec);
+  workers[0]->enumerate_subtrees(*this, prec);
+  for (auto &thread : threads)
+    thread.join();
+
+  thread_nodes.resize(_threads);
+  for (unsigned int i = 0; i < _threads; ++i)
+  {
+    thread_nodes[i] = workers[i]->get_nodes();
+    for (int j = 0; j < d; ++j)
+      nodes[j] += workers[i]->nodes[j];
+    nr_solutions += workers[i]->nr_solutions;
+    nr_subsolutions += workers[i]->nr_subsolutions;
+  }
+  thread_nodes[0] += split_nodes;
+  maxdist = state.maxdist.load();
+  shared  = nullptr;
+}
+
+/* Enumerates the top `levels` levels of the SVP tree (without the symmetric half) and stores the
+   coordinates of each node of the lowest level in `subtrees`. */
+template <typename FT, int N>
+void EnumerationDyn<FT, N>::split_subtrees(int levels, std::deque<Subtree> &subtrees)
+{
+  subtrees.clear();
+  nodes.fill(0);
+  int k_split = d - levels;
+
+  k           = d - 1;
+  x[k]        = 0;
+  center[k]   = 0.0;
+  partdist[k] = 0.0;
+  while (true)
+  {
+    enumf alphak  = x[k] - center[k];
+    enumf newdist = partdist[k] + alphak * alphak * rdiag[k];
+    if (newdist <= partdistbounds[k])
+    {
+      ++nodes[this->node_level(k)];
+      alpha[k] = alphak;
+      if (_evaluator->findsubsols && newdist < subsoldists[k])
+      {
+        subsoldists[k] = newdist;
+        process_subsolution(k, newdist);
+      }
+      if (k > k_split)
+      {
+        --k;
+        enumf newcenter = 0.0;
+        for (int j = k + 1; j < d; ++j)
+          newcenter -= x[j] * mut[k][j];
+        center[k]   = newcenter;
+        partdist[k] = newdist;
+        roundto(x[k], newcenter);
+        dx[k] = ddx[k] = (((int)(newcenter >= x[k]) & 1) << 1) - 1;
+        continue;
+      }
+      subtrees.push_back(Subtree{vector<enumxt>(&x[k_split], &x[0] + d), false, 0, 0, 0});
+    }
+    else if (++k >= d)
+    {
+      break;
+    }
+    if (partdist[k] != 0.0)
+    {
+      x[k] += dx[k];
+      ddx[k] = -ddx[k];
+      dx[k]  = ddx[k] - dx[k];
+    }
+    else
+    {
+      ++x[k];
+    }
+  }
+}
+
+/* Worker thread of a parallel enumeration: copies the enumeration data of `master` and enumerates
+   subtrees until all threads are idle. The floating-point precision of the caller is passed in
+   `prec` since it is a per-thread setting for mpfr. */
+template <typename FT, int N>
+void EnumerationDyn<FT, N>::enumerate_subtrees(const EnumerationDyn<FT, N> &master,
+                                               unsigned int prec)
+{
+  FT::set_prec(prec);
+  nr_solutions    = 0;
+  nr_subsolutions = 0;
+  d               = master.d;
+  dual            = false;
+  resetflag       = false;
+  pruning_bounds  = master.pruning_bounds;
+  rdiag           = master.rdiag;
+  subsoldists     = master.subsoldists;
+  shared          = master.shared;
+  stop_flag       = master.stop_flag;
+  float_levels    = master.float_levels;
+  level_stats     = master.level_stats;
+  for (int i = 0; i < d; ++i)
+    std::copy(master.mut[i], master.mut[i] + d, mut[i]);
+  prepare_float_levels();
+
+  array<uint64_t, maxdim> total_nodes;
+  total_nodes.fill(0);
+  Subtree subtree;
+  save_rounding();
+  polling = true;
+  while (next_subtree(subtree))
+  {
+    maxdist = shared->maxdist.load();
+    enumerate_subtree(subtree);
+    for (int i = 0; i < d; ++i)
+      total_nodes[i] += nodes[i];
+  }
+  polling = false;
+  restore_rounding();
+  nodes = total_nodes;
+}
+
+/* Enumerates the SVP tree below the prefix of `subtree`. */
+template <typename FT, int N> void EnumerationDyn<FT, N>::enumerate_subtree(const Subtree &subtree)
+{
+  fill(center_partsum.begin(), center_partsum.begin() + d, 0.0);
+  prepare_enumeration(subtree.prefix, true, false);
+  if (!subtree.resume)
+  {
+    do_enumerate();
+    return;
+  }
+  x[k_end - 1]   = subtree.x;
+  dx[k_end - 1]  = subtree.dx;
+  ddx[k_end - 1] = subtree.ddx;
+  // the enumeration starts from the sibling instead of the path set up by prepare_enumeration()
+  do_enumerate(false);
+}
+
+/* Takes the next subtree from the queue of a parallel enumeration. If the queue is empty, waits
+   until another thread hands over work. Returns false once all threads are waiting. */
+template <typename FT, int N> bool EnumerationDyn<FT, N>::next_subtree(Subtree &subtree)
+{
+  std::unique_lock<std::mutex> lock(shared->mutex);
+  while (shared->subtrees.empty() && !shared->done)
+  {
+    if (++shared->idle == shared->threads)
+    {
+      shared->done = true;
+      shared->wakeup.notify_all();
+      break;
+    }
+    shared->wakeup.wait(lock);
+    --shared->idle;
+  }
+  if (shared->subtrees.empty())
+    return false;
+  subtree = std::move(shared->subtrees.front());
+  shared->subtrees.pop_front();
+  return true;
+}
+
+/* Subtree of the siblings of the current node at `level` which are not enumerated yet. */
+template <typename FT, int N>
+typename EnumerationDyn<FT, N>::Subtree EnumerationDyn<FT, N>::next_siblings(int level)
+{
+  Subtree subtree;
+  subtree.prefix.assign(&x[level + 1], &x[0] + d);
+  subtree.resume = true;
+  if (partdist[level] != 0.0)
+  {
+    subtree.x   = x[level] + dx[level];
+    subtree.ddx = -ddx[level];
+    subtree.dx  = subtree.ddx - dx[level];
+  }
+  else
+  {
+    subtree.x   = x[level] + 1;
+    subtree.dx  = dx[level];
+    subtree.ddx = ddx[level];
+  }
+  return subtree;
+}
+
+/* Called regularly during the enumeration of a worker thread, or of an enumeration with
+   checkpoints. The reset subproblems of a parallel CVP enumeration adopt the shared bound. In a
+   parallel SVP enumeration, if other threads are idle, the remaining siblings at the highest level
+   which is still enumerated by this thread are handed over to them as a new subtree, and the level
+   is cut from the enumeration of this thread. Levels close to poll_level are never handed over,
+   their subtrees are too small. */
+template <typename FT, int N> void EnumerationDyn<FT, N>::poll()
+{
+  if (stop_flag != nullptr && stop_flag->load(std::memory_order_relaxed) && maxdist > 0.0)
+  {
+    maxdist = 0.0;
+    set_bounds();
+    return;
+  }
+  if (reset_worker != nullptr)
+  {
+    enumf bound = reset_worker->bound.load(std::memory_order_relaxed) - reset_offset;
+    if (bound < maxdist)
+    {
+      maxdist = bound;
+      set_bounds();
+    }
+    return;
+  }
+  if (shared == nullptr)
+  {
+    if (!checkpointing || --checkpoint_polls > 0)
+      return;
+    checkpoint_polls = int(min(max(checkpoint_interval >> 10, uint64_t(1)), uint64_t(1024)));
+    uint64_t total_nodes = std::accumulate(finished_nodes.begin(), finished_nodes.begin() + d,
+                                           this->get_nodes());
+    if (total_nodes >= next_checkpoint)
+    {
+      write_checkpoint();
+      next_checkpoint = total_nodes + checkpoint_interval;
+    }
+    return;
+  }
+
+  // adopt the bound lowered by a solution of another thread
+  enumf bound = shared->maxdist.load(std::memory_order_relaxed);
+  if (bound < maxdist)
+  {
+    maxdist = bound;
+    set_bounds();
+  }
+
+  int l = cut_level - 1;
+  if (shared->idle.load(std::memory_order_relaxed) == 0 || l <= poll_level)
+    return;
+
+  Subtree subtree = next_siblings(l);
+  {
+    std::lock_guard<std::mutex> lock(shared->mutex);
+    if (shared->subtrees.size() >= shared->idle)
+      return;
+    shared->subtrees.push_back(std::move(subtree));
+  }
+  shared->wakeup.notify_one();
+  cut_level         = l;
+  partdistbounds[l] = -1.0;
+}
+
+/* SVP enumeration which saves its state regularly (see set_checkpoint()). As in the parallel
+   enumeration, the tree is enumerated as a sequence of subtrees: a checkpoint lists the remaining
+   siblings of the current node at each level from poll_level up, followed by the subtrees which
+   are not started yet. */
+template <typename FT, int N> void EnumerationDyn<FT, N>::enumerate_checkpointed(long normexp)
+{
+  checkpoint_normexp = normexp;
+  pending_subtrees.clear();
+  finished_nodes.fill(0);
+  if (!resume_checkpoint || !read_checkpoint())
+    pending_subtrees.push_back(Subtree{vector<enumxt>(), false, 0, 0, 0});
+  next_checkpoint =
+      std::accumulate(finished_nodes.begin(), finished_nodes.begin() + d, checkpoint_interval);
+  checkpoint_polls = 1;
+
+  save_rounding();
+  polling       = true;
+  checkpointing = true;
+  while (!pending_subtrees.empty())
+  {
+    Subtree subtree = std::move(pending_subtrees.front());
+    pending_subtrees.pop_front();
+    enumerate_subtree(subtree);
+    for (int i = 0; i < d; ++i)
+      finished_nodes[i] += nodes[i];
+  }
+  polling       = false;
+  checkpointing = false;
+  restore_rounding();
+  nodes = finished_nodes;
+  std::remove(checkpoint_file.c_str());
+}
+
+/* Checkpoint file: all values are written in the byte order of the machine. */
+static const char ENUM_CHECKPOINT_MAGIC[8] = {'F', 'P', 'L', 'L', 'E', 'N', 'U', '1'};
+
+template <class T> static inline void write_value(std::ostream &out, const T &value)
+{
+  out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <class T> static inline void read_value(std::istream &in, T &value)
+{
+  in.read(reinterpret_cast<char *>(&value), sizeof(T));
+}
+
+template <class Subtree> static void write_subtree(std::ostream &out, const Subtree &subtree)
+{
+  write_value(out, uint64_t(subtree.prefix.size()));
+  for (enumxt coord : subtree.prefix)
+    write_value(out, coord);
+  write_value(out, uint8_t(subtree.resume));
+  write_value(out, subtree.x);
+  write_value(out, subtree.dx);
+  write_value(out, subtree.ddx);
+}
+
+/* The checkpoint is written to a temporary file first, so that an interruption while writing it
+   leaves the previous checkpoint intact. */
+template <typename FT, int N> void EnumerationDyn<FT, N>::write_checkpoint()
+{
+  string tmp_file = checkpoint_file + ".tmp";
+  std::ofstream out(tmp_file.c_str(), std::ios::binary | std::ios::trunc);
+  FPLLL_CHECK(out, "enumerate: cannot write the checkpoint file");
+
+  out.write(ENUM_CHECKPOINT_MAGIC, sizeof(ENUM_CHECKPOINT_MAGIC));
+  write_value(out, int32_t(d));
+  write_value(out, int64_t(checkpoint_normexp));
+  for (int i = 0; i < d; ++i)
+    write_value(out, rdiag[i]);
+  write_value(out, uint64_t(pruning_bounds.size()));
+  for (enumf bound : pruning_bounds)
+    write_value(out, bound);
+  write_value(out, maxdist);
+  for (int i = 0; i < d; ++i)
+    write_value(out, finished_nodes[i] + nodes[i]);
+
+  _evaluator->sync_solutions();
+  FT dist;
+  write_value(out, uint64_t(_evaluator->size()));
+  for (auto it = _evaluator->begin(), itend = _evaluator->end(); it != itend; ++it)
+  {
+    dist.mul_2si(it->first, -checkpoint_normexp);
+    write_value(out, dist.get_d());
+    for (int i = 0; i < d; ++i)
+      write_value(out, enumxt(it->second[i].get_d()));
+  }
+  // the evaluator takes back the solutions it keeps during the enumeration
+  _evaluator->set_normexp(checkpoint_normexp);
+
+  write_value(out, uint64_t(cut_level - poll_level + pending_subtrees.size()));
+  for (int l = poll_level; l < cut_level; ++l)
+    write_subtree(out, next_siblings(l));
+  for (const Subtree &subtree : pending_subtrees)
+    write_subtree(out, subtree);
+
+  out.close();
+  FPLLL_CHECK(out, "enumerate: cannot write the checkpoint file");
+  FPLLL_CHECK(std::rename(tmp_file.c_str(), checkpoint_file.c_str()) == 0,
+              "enumerate: cannot write the checkpoint file");
+}
+
+/* Reads the checkpoint of the enumeration which is being started. Returns false if there is no
+   checkpoint file. */
+template <typename FT, int N> bool EnumerationDyn<FT, N>::read_checkpoint()
+{
+  std::ifstream in(checkpoint_file.c_str(), std::ios::binary);
+  if (!in)
+    return false;
+
+  char magic[sizeof(ENUM_CHECKPOINT_MAGIC)];
+  int32_t saved_d;
+  int64_t saved_normexp;
+  in.read(magic, sizeof(magic));
+  read_value(in, saved_d);
+  read_value(in, saved_normexp);
+  FPLLL_CHECK(in && std::equal(magic, magic + sizeof(magic), ENUM_CHECKPOINT_MAGIC),
+              "enumerate: invalid checkpoint file");
+  bool same_enum = saved_d == d && saved_normexp == checkpoint_normexp;
+  enumf value;
+  for (int i = 0; i < d && same_enum; ++i)
+  {
+    read_value(in, value);
+    same_enum = value == rdiag[i];
+  }
+  uint64_t count;
+  read_value(in, count);
+  same_enum = same_enum && count == pruning_bounds.size();
+  for (uint64_t i = 0; i < count && same_enum; ++i)
+  {
+    read_value(in, value);
+    same_enum = value == pruning_bounds[i];
+  }
+  FPLLL_CHECK(in && same_enum, "enumerate: the checkpoint belongs to another enumeration");
+
+  read_value(in, value);
+  maxdist = min(maxdist, value);
+  for (int i = 0; i < d; ++i)
+    read_value(in, finished_nodes[i]);
+
+  vector<enumxt> coord(d);
+  read_value(in, count);
+  for (uint64_t i = 0; i < count && in; ++i)
+  {
+    read_value(in, value);
+    for (int j = 0; j < d; ++j)
+      read_value(in, coord[j]);
+    _evaluator->eval_raw_sol(&coord[0], d, value, maxdist);
+  }
+
+  read_value(in, count);
+  for (uint64_t i = 0; i < count && in; ++i)
+  {
+    Subtree subtree;
+    uint64_t size;
+    uint8_t resume;
+    read_value(in, size);
+    subtree.prefix.resize(size);
+    for (uint64_t j = 0; j < size && in; ++j)
+      read_value(in, subtree.prefix[j]);
+    read_value(in, resume);
+    read_value(in, subtree.x);
+    read_value(in, subtree.dx);
+    read_value(in, subtree.ddx);
+    subtree.resume = resume != 0;
+    FPLLL_CHECK(in && size <= uint64_t(d), "enumerate: invalid checkpoint file");
+    pending_subtrees.push_back(std::move(subtree));
+  }
+  FPLLL_CHECK(in, "enumerate: invalid checkpoint file");
+  return true;
+}
+
+template <typename FT> void BatchEnumeration<FT>::enumerate(vector<EnumerationJob<FT>> &jobs)
+{
+  _nodes = 0;
+  if (jobs.empty())
+    return;
+
+  EnumerationGSOData gso_data;
+  gso_data.first = _gso.d;
+  gso_data.last  = 0;
+  for (EnumerationJob<FT> &job : jobs)
+  {
+    if (job.last == -1)
+      job.last = _gso.d;
+    FPLLL_CHECK(0 <= job.first && job.first < job.last && job.last <= _gso.d,
+                "BatchEnumeration: invalid block");
+    gso_data.first = min(gso_data.first, job.first);
+    gso_data.last  = max(gso_data.last, job.last);
+  }
+  convert_gso(gso_data);
+  enumerate(gso_data, jobs);
+}
+
+template <typename FT>
+void BatchEnumeration<FT>::enumerate(const EnumerationGSOData &gso_data,
+                                     vector<EnumerationJob<FT>> &jobs)
+{
+  _nodes = 0;
+  for (EnumerationJob<FT> &job : jobs)
+  {
+    if (job.last == -1)
+      job.last = gso_data.last;
+    FPLLL_CHECK(gso_data.first <= job.first && job.first < job.last && job.last <= gso_data.last,
+                "BatchEnumeration: the block is not in the converted GSO data");
+  }
+
+  std::atomic<size_t> next_job(0);
+  unsigned int prec = FT::get_prec();
+  vector<std::thread> threads;
+  for (unsigned int i = 1; i < min<size_t>(_threads, jobs.size()); ++i)
+    threads.emplace_back(&BatchEnumeration<FT>::enumerate_jobs, this, std::cref(gso_data),
+                         std::ref(jobs), std::ref(next_job), prec);
+  enumerate_jobs(gso_data, jobs, next_job, prec);
+  for (auto &thread : threads)
+    thread.join();
+
+  for (const EnumerationJob<FT> &job : jobs)
+    _nodes += job.nodes;
+}
+
+/* Converts mu and r to enumf. The exponent of r is kept apart, so that each job can normalize its
+   block as EnumerationDyn::enumerate() does. */
+template <typename FT> void BatchEnumeration<FT>::convert_gso(EnumerationGSOData &gso_data)
+{
+  int first = gso_data.first;
+  int n     = gso_data.last - first;
+  gso_data.mu.resize(n * n);
+  gso_data.r_mant.resize(n);
+  gso_data.r_expo.resize(n);
+
+  FT fr, fmu;
+  long rexpo;
+  if (_gso.enable_double_shadow)
+  {
+    _gso.update_double_shadow(first, gso_data.last);
+    for (int i = 0; i < n; ++i)
+    {
+      gso_data.r_mant[i] = _gso.get_double_shadow_r(i + first, gso_data.r_expo[i]);
+      for (int j = 0; j < i; ++j)
+        gso_data.mu[i * n + j] = _gso.get_double_shadow_mu(j + first)[i + first];
+    }
+    return;
+  }
+  for (int i = 0; i < n; ++i)
+  {
+    fr = _gso.get_r_exp(i + first, i + first, rexpo);
+    gso_data.r_expo[i] = rexpo + fr.exponent();
+    fr.mul_2si(fr, -fr.exponent());
+    gso_data.r_mant[i] = fr.get_d();
+    for (int j = 0; j < i; ++j)
+    {
+      _gso.get_mu(fmu, i + first, j + first);
+      gso_data.mu[i * n + j] = fmu.get_d();
+    }
+  }
+}
+
+/* Worker thread of a batch enumeration: runs the jobs which are not taken yet, using the smallest
+   kernel which fits the dimension of each job (see Enumeration::enumerate()). */
+template <typename FT>
+void BatchEnumeration<FT>::enumerate_jobs(const EnumerationGSOData &gso_data,
+                                          vector<EnumerationJob<FT>> &jobs,
+                                          std::atomic<size_t> &next_job, unsigned int prec)
+{
+  FT::set_prec(prec);
+  std::unique_ptr<EnumerationDyn<FT>> enumdyn;
+#if FPLLL_MAX_ENUM_DIMENSION > 32
+  std::unique_ptr<EnumerationDyn<FT, 32>> enumdyn32;
+#endif
+#if FPLLL_MAX_ENUM_DIMENSION > 48
+  std::unique_ptr<EnumerationDyn<FT, 48>> enumdyn48;
+#endif
+#if FPLLL_MAX_ENUM_DIMENSION > 64
+  std::unique_ptr<EnumerationDyn<FT, 64>> enumdyn64;
+#endif
+#if FPLLL_MAX_ENUM_DIMENSION > 96
+  std::unique_ptr<EnumerationDyn<FT, 96>> enumdyn96;
+#endif
+
+  for (size_t i = next_job++; i < jobs.size(); i = next_job++)
+  {
+    EnumerationJob<FT> &job = jobs[i];
+    int d                   = job.last - job.first;
+#if FPLLL_MAX_ENUM_DIMENSION > 32
+    if (d < 32)
+    {
+      enumerate_job(enumdyn32, gso_data, job);
+      continue;
+    }
+#endif
+#if FPLLL_MAX_ENUM_DIMENSION > 48
+    if (d < 48)
+    {
+      enumerate_job(enumdyn48, gso_data, job);
+      continue;
+    }
+#endif
+#if FPLLL_MAX_ENUM_DIMENSION > 64
+    if (d < 64)
+    {
+      enumerate_job(enumdyn64, gso_data, job);
+      continue;
+    }
+#endif
+#if FPLLL_MAX_ENUM_DIMENSION > 96
+    if (d < 96)
+    {
+      enumerate_job(enumdyn96, gso_data, job);
+      continue;
+    }
+#endif
+    enumerate_job(enumdyn, gso_data, job);
+  }
+}
+
+// kernels for small dimensions, see Enumeration::enumerate()
+#if FPLLL_MAX_ENUM_DIMENSION > 32
+#define ENUM_INSTANTIATE_32(FT) template class EnumerationDyn<FT, 32>;
+#else
+#define ENUM_INSTANTIATE_32(FT)
+#endif
+#if FPLLL_MAX_ENUM_DIMENSION > 48
+#define ENUM_INSTANTIATE_48(FT) template class EnumerationDyn<FT, 48>;
+#else
+#define ENUM_INSTANTIATE_48(FT)
+#endif
+#if FPLLL_MAX_ENUM_DIMENSION > 64
+#define ENUM_INSTANTIATE_64(FT) template class EnumerationDyn<FT, 64>;
+#else
+#define ENUM_INSTANTIATE_64(FT)
+#endif
+#if FPLLL_MAX_ENUM_DIMENSION > 96
+#define ENUM_INSTANTIATE_96(FT) template class EnumerationDyn<FT, 96>;
+#else
+#define ENUM_INSTANTIATE_96(FT)
+#endif
+
+#define ENUM_INSTANTIATE(FT)                                                                       \
+  template class Enumeration<FT>;                                                                  \
+  template class EnumerationDyn<FT>;                                                               \
+  template class BatchEnumeration<FT>;                                                             \
+  ENUM_INSTANTIATE_32(FT) ENUM_INSTANTIATE_48(FT) ENUM_INSTANTIATE_64(FT) ENUM_INSTANTIATE_96(FT)
+
+ENUM_INSTANTIATE(FP_NR<double>)
 
 #ifdef FPLLL_WITH_LONG_DOUBLE
-template class Enumeration<FP_NR<long double>>;
-template class EnumerationDyn<FP_NR<long double>>;
+ENUM_INSTANTIATE(FP_NR<long double>)
 #endif
 
 #ifdef FPLLL_WITH_QD
-template class Enumeration<FP_NR<dd_real>>;
-template class EnumerationDyn<FP_NR<dd_real>>;
-
-template class Enumeration<FP_NR<qd_real>>;
-template class EnumerationDyn<FP_NR<qd_real>>;
+ENUM_INSTANTIATE(FP_NR<dd_real>)
+ENUM_INSTANTIATE(FP_NR<qd_real>)
 #endif
 
 #ifdef FPLLL_WITH_DPE
-template class Enumeration<FP_NR<dpe_t>>;
-template class EnumerationDyn<FP_NR<dpe_t>>;
+ENUM_INSTANTIATE(FP_NR<dpe_t>)
 #endif
 
-template class Enumeration<FP_NR<mpfr_t>>;
-template class EnumerationDyn<FP_NR<mpfr_t>>;
+ENUM_INSTANTIATE(FP_NR<mpfr_t>)
 
 FPLLL_END_NAMESPACE
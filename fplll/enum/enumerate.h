@@ -20,20 +20,156 @@
 #define FPLLL_ENUMERATE_H
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <fplll/enum/enumerate_base.h>
 #include <fplll/enum/enumerate_ext.h>
 #include <fplll/enum/evaluator.h>
 #include <fplll/gso.h>
+#include <map>
 #include <memory>
+#include <mutex>
 
 FPLLL_BEGIN_NAMESPACE
 
-template <typename FT> class EnumerationDyn : public EnumerationBase
+/* Parallel enumeration: the number of levels left to the worker threads is at least
+   ENUM_PARALLEL_MIN_LEVELS, the top levels are split until there are
+   ENUM_PARALLEL_SUBTREES_PER_THREAD subtrees per thread. Subtrees of very different sizes are
+   balanced at runtime: busy threads hand over part of their work to idle ones. */
+const int ENUM_PARALLEL_MIN_LEVELS          = 10;
+const int ENUM_PARALLEL_SUBTREES_PER_THREAD = 32;
+
+/* Parallel CVP with resets: the main thread hands over up to ENUM_RESET_JOBS_PER_THREAD reset
+   subproblems per worker thread, it enumerates the next ones itself while the queue is full. */
+const int ENUM_RESET_JOBS_PER_THREAD = 4;
+
+/* Default number of nodes between two checkpoints of an enumeration (see
+   EnumerationDyn::set_checkpoint()), between a few seconds and a minute. */
+const uint64_t ENUM_CHECKPOINT_INTERVAL = 1000000000;
+
+/* Mixed-precision enumeration (see EnumerationDyn::set_float_levels()): relative increase of the
+   pruning bounds of the levels whose centers are computed in float. */
+const double ENUM_FLOAT_SLACK = 1.0 / 4096;
+
+/* GSO data of the rows [first, last) of a basis converted for the enumeration of many blocks (see
+   BatchEnumeration): mu(i, j) and r(i, i) = r_mant(i) * 2^r_expo(i), with 1/2 <= r_mant(i) < 1. */
+struct EnumerationGSOData
+{
+  int first, last;
+  vector<enumf> mu, r_mant;
+  vector<long> r_expo;
+
+  inline enumf get_mu(int i, int j) const { return mu[(i - first) * (last - first) + j - first]; }
+};
+
+/**
+ * SVP enumeration of the block [first, last) in a batch (see BatchEnumeration). The squared radius
+ * maxdist * 2^maxdistexpo is updated by the enumeration as in Enumeration::enumerate(), the
+ * solutions are stored in the evaluator of the job and nodes is the number of nodes visited.
+ * If target is set, the job is a CVP enumeration instead: target holds the coordinates of the
+ * target in the Gram-Schmidt basis of the block, and max_indices are the levels of the resets as
+ * in Enumeration.
+ */
+template <typename FT> struct EnumerationJob
+{
+  EnumerationJob(int first, int last, const FT &maxdist, long maxdistexpo = 0,
+                 const vector<enumf> &pruning = vector<enumf>(), bool dual = false,
+                 size_t nr_solutions                = 1,
+                 EvaluatorStrategy evaluator_strategy = EVALSTRATEGY_BEST_N_SOLUTIONS)
+      : first(first), last(last), maxdist(maxdist), maxdistexpo(maxdistexpo), pruning(pruning),
+        dual(dual), evaluator(nr_solutions, evaluator_strategy), nodes(0)
+  {
+  }
+
+  int first, last;
+  FT maxdist;
+  long maxdistexpo;
+  vector<enumf> pruning;
+  bool dual;
+  PooledEvaluator<FT> evaluator;
+  uint64_t nodes;
+  vector<enumf> target;
+  vector<int> max_indices;
+};
+
+/**
+ * Statistics of the last run of an Enumeration (see Enumeration::get_stats()). With
+ * Enumeration::set_detailed_stats(), the nodes are counted at each level, level i being the i-th
+ * row of the enumerated block: the root of the tree is the last level, as in the detailed cost
+ * computed by Pruner::single_enum_cost().
+ */
+struct EnumerationStats
 {
+  EnumerationStats() : solutions(0), subsolutions(0), seconds(0.0) {}
+
+  vector<uint64_t> level_nodes;  //< nodes visited at each level, empty for external enumerators
+  uint64_t solutions;            //< solutions passed to the evaluator
+  uint64_t subsolutions;         //< subsolutions passed to the evaluator
+  double seconds;                //< wall time of the enumeration, only with detailed statistics
+  string backend;  //< external enumerator which did the enumeration, empty for fplll's own
+
+  /**
+   * Ratio of the nodes visited to the nodes expected at each level, e.g. from the detailed cost of
+   * a Pruning. The ratio is 0 at the levels where no node is expected.
+   */
+  vector<double> cost_ratios(const vector<double> &detailed_cost) const
+  {
+    FPLLL_CHECK(detailed_cost.size() == level_nodes.size(),
+                "cost_ratios: expected cost and enumeration have different dimensions");
+    vector<double> ratios(level_nodes.size(), 0.0);
+    for (size_t i = 0; i < level_nodes.size(); ++i)
+    {
+      if (detailed_cost[i] > 0.0)
+        ratios[i] = level_nodes[i] / detailed_cost[i];
+    }
+    return ratios;
+  }
+};
+
+/* Enumeration of dimension d < N, see EnumerationBase. */
+template <typename FT, int N = FPLLL_MAX_ENUM_DIMENSION>
+class EnumerationDyn : public EnumerationBase<N>
+{
+  typedef EnumerationBase<N> Base;
+  using Base::maxdim;
+  using Base::poll_level;
+  using Base::dual;
+  using Base::is_svp;
+  using Base::resetflag;
+  using Base::mut;
+  using Base::rdiag;
+  using Base::partdistbounds;
+  using Base::d;
+  using Base::k_end;
+  using Base::center_partsum;
+  using Base::float_levels;
+  using Base::prepare_float_levels;
+  using Base::partdist;
+  using Base::center;
+  using Base::alpha;
+  using Base::x;
+  using Base::dx;
+  using Base::ddx;
+  using Base::subsoldists;
+  using Base::_max_indices;
+  using Base::reset_depth;
+  using Base::k;
+  using Base::k_max;
+  using Base::nodes;
+  using Base::level_stats;
+  using Base::polling;
+  using Base::save_rounding;
+  using Base::restore_rounding;
+
 public:
   EnumerationDyn(MatGSO<Integer, FT> &gso, Evaluator<FT> &evaluator,
                  const vector<int> &max_indices = vector<int>())
-      : _gso(gso), _evaluator(evaluator)
+      : _gso(gso), _evaluator(&evaluator), _threads(1), nr_solutions(0), nr_subsolutions(0),
+        shared(nullptr), reset_contexts_loaded(false), reset_state(nullptr),
+        reset_worker(nullptr), checkpoint_interval(ENUM_CHECKPOINT_INTERVAL),
+        resume_checkpoint(false), checkpointing(false), stop_flag(nullptr), float_cutoff(0)
   {
     _max_indices = max_indices;
   }
@@ -44,22 +180,235 @@ public:
                  const vector<enumf> &pruning = vector<enumf>(), bool dual = false,
                  bool subtree_reset = false);
 
-  inline uint64_t get_nodes() const { return nodes; }
+  /**
+   * Enumerates a job of a batch from the GSO data converted by BatchEnumeration, the solutions are
+   * given to the evaluator of the job instead of the evaluator of this object.
+   */
+  void enumerate(const EnumerationGSOData &gso_data, EnumerationJob<FT> &job);
+
+  /**
+   * Number of threads used by enumerate().
+   * With more than one thread, the top levels of the enumeration tree are split into subtrees
+   * which are enumerated concurrently. This is only done for primal SVP enumeration without a
+   * given subtree. For CVP with max_indices, the reset subproblems are enumerated concurrently
+   * instead. All other instances are enumerated by the calling thread.
+   */
+  void set_threads(unsigned int threads) { _threads = max(threads, 1u); }
+  inline unsigned int get_threads() const { return _threads; }
+
+  /**
+   * Number of nodes visited by each thread during the last parallel enumeration (the nodes of the
+   * split of the top levels are counted for the first thread). Their sum is get_nodes().
+   */
+  inline const vector<uint64_t> &get_thread_nodes() const { return thread_nodes; }
+
+  /** Number of solutions and subsolutions passed to the evaluator by the last enumeration. */
+  inline uint64_t get_solutions() const { return nr_solutions; }
+  inline uint64_t get_subsolutions() const { return nr_subsolutions; }
+
+  /**
+   * Saves the state of long enumerations: every `interval` nodes, the subtrees left, the bound, the
+   * node counts and the solutions found so far are written to `filename` in binary form, replacing
+   * the previous checkpoint. The file is removed when the enumeration is finished. If `resume` is
+   * set and `filename` holds a checkpoint, enumerate() continues the saved enumeration, which must
+   * be the same (same GSO data, bound and pruning) as the one being started.
+   *
+   * Only primal SVP enumerations without subtree, CVP reset and subsolutions are checkpointed, they
+   * are then run on a single thread. An empty filename disables the checkpoints.
+   */
+  void set_checkpoint(const string &filename, uint64_t interval = ENUM_CHECKPOINT_INTERVAL,
+                      bool resume = false)
+  {
+    checkpoint_file     = filename;
+    checkpoint_interval = max(interval, uint64_t(1));
+    resume_checkpoint   = resume;
+  }
+
+  /**
+   * Stops enumerate() early once `*stop` is set, e.g. by another thread: the flag is read each
+   * time the subtree of a node at level poll_level is finished, then the bound is set to zero as
+   * with EVALSTRATEGY_FIRST_N_SOLUTIONS. The solutions found so far are kept by the evaluator.
+   * nullptr disables it.
+   */
+  void set_stop_flag(const std::atomic<bool> *stop) { stop_flag = stop; }
+
+  /**
+   * Mixed-precision enumeration: the levels below `levels` keep their rows of mu and of the partial
+   * sums of the centers in float instead of double, which halves the memory read at each node of
+   * these levels. Their pruning bounds are multiplied by 1 + ENUM_FLOAT_SLACK, and the distance of
+   * each solution is computed again in double before it is given to the evaluator: solutions
+   * beyond the bound are dropped. 0 (the default) disables it. Only primal SVP enumerations
+   * without CVP reset and subsolutions use it.
+   *
+   * Error analysis: let u = 2^-24. The center of level k is the sum of the m = k_end - k - 1 terms
+   * -x_j * mu(j, k) and of the partial sum of the levels above k_end, each of them rounded once to
+   * float, then added with m + 1 roundings. Its error is then |e_k| <= (m + 2) * u * S_k, where S_k
+   * is the sum of the absolute values of the terms. The distance partdist(k) + (x_k - c_k)^2 r_k
+   * of a node under the bound B has |x_k - c_k| sqrt(r_k) <= sqrt(B), so its error is at most
+   * (2 eps + eps^2) B with eps = |e_k| sqrt(r_k / B). With ENUM_FLOAT_SLACK = 2^-12, no node is
+   * pruned by mistake as long as eps <= 2^-14, that is (m + 2) * S_k * sqrt(r_k / B) <= 2^10: e.g.
+   * r_k <= B and S_k <= 16 for a block of dimension 64. The actual errors are usually much smaller
+   * than this bound. Beyond it, a few nodes close to the bounds might be missed, but no solution
+   * is wrong.
+   */
+  void set_float_levels(int levels) { float_cutoff = max(levels, 0); }
+
+  /**
+   * Counts the nodes of each level (see get_nodes(int)). The enumeration then runs a separate
+   * instance of the kernel, which is not compiled for AVX2. By default, the kernel only counts the
+   * total number of nodes.
+   */
+  void set_level_stats(bool enable) { level_stats = enable; }
 
 private:
+  /* Subtree of a parallel enumeration: all nodes below the coordinates `prefix` of the top levels.
+     If `resume` is set, the level below the prefix starts at the sibling x with zigzag steps dx
+     and ddx instead of the integer closest to the center. */
+  struct Subtree
+  {
+    vector<enumxt> prefix;
+    bool resume;
+    enumxt x, dx, ddx;
+  };
+
+  /* State shared by the threads of a parallel enumeration. */
+  struct SharedState
+  {
+    std::atomic<enumf> maxdist;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::deque<Subtree> subtrees;
+    std::atomic<unsigned int> idle;  // threads waiting for a subtree
+    unsigned int threads;
+    bool done;
+  };
+
+  /* Subproblem of a CVP reset: the levels <= depth below the coordinates `prefix` of the levels
+     above, which are at distance `dist` of the target. */
+  struct ResetJob
+  {
+    vector<enumxt> prefix;
+    int depth;
+    enumf dist;
+  };
+
+  /* Closest vector of a reset subproblem, all coordinates of x are set. */
+  struct ResetResult
+  {
+    vector<enumxt> x;
+    enumf dist;
+  };
+
+  /* Enumeration of reset subproblems: the enumeration data is copied from the enumeration which
+     resets (see load_reset_data()) and the object is reused for all its resets. */
+  struct ResetContext
+  {
+    ResetContext(MatGSO<Integer, FT> &gso, const vector<int> &max_indices)
+        : enumobj(gso, evaluator, max_indices)
+    {
+    }
+    PooledEvaluator<FT> evaluator;
+    EnumerationDyn<FT, N> enumobj;
+  };
+
+  /* State shared by the threads of a parallel CVP enumeration with resets. */
+  struct ResetState
+  {
+    std::atomic<enumf> bound;  // distance to the target of the closest vector found so far
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::deque<ResetJob> jobs;
+    vector<ResetResult> results;
+    bool done;
+  };
+
   MatGSO<Integer, FT> &_gso;
-  Evaluator<FT> &_evaluator;
+  Evaluator<FT> *_evaluator;
   vector<FT> target;
+  unsigned int _threads;
+  vector<uint64_t> thread_nodes;
+  uint64_t nr_solutions, nr_subsolutions;
+
+  /* parallel SVP enumeration: the workers are kept between enumerations, the first one is used
+     by the calling thread and the others by the worker threads (see enumerate_parallel()) */
+  vector<std::unique_ptr<EnumerationDyn<FT, N>>> workers;
+  /* state of the parallel enumeration this object is a worker of (nullptr if serial) */
+  SharedState *shared;
+  /* the levels >= cut_level below the subtree have been handed over to other threads */
+  int cut_level;
+
+  /* CVP resets: the contexts are kept between enumerations, the first one is used by the calling
+     thread and the others by the worker threads (see enumerate_reset_parallel()) */
+  vector<std::unique_ptr<ResetContext>> reset_contexts;
+  bool reset_contexts_loaded;
+  array<enumf, maxdim> reset_center;  // center_partsum before the subtree is subtracted
+  array<enumf, maxdim> reset_radius;  // sum of rdiag[0..i], bound of the reset below level i
+  ResetJob reset_job;
+  ResetResult reset_result;
+  ResetState *reset_state;   // parallel CVP of which this object is the calling thread
+  ResetState *reset_worker;  // parallel CVP of which this object is a worker thread
+  enumf reset_offset;        // distance to the target of the prefix of the current reset
+
+  /* checkpoints, see set_checkpoint() */
+  string checkpoint_file;
+  uint64_t checkpoint_interval, next_checkpoint;
+  bool resume_checkpoint;
+  bool checkpointing;  // poll() writes the checkpoints
+  long checkpoint_normexp;
+  int checkpoint_polls;                      // calls of poll() before the nodes are counted again
+  std::deque<Subtree> pending_subtrees;      // subtrees not started yet
+  array<uint64_t, maxdim> finished_nodes;    // nodes of the subtrees already enumerated
+
+  const std::atomic<bool> *stop_flag;  // see set_stop_flag()
+  int float_cutoff;                     // see set_float_levels()
+
+  /* Dual GSO of a block (rdiag and the upper triangle of mut, row by row), with the stamps of its
+     rows (see MatGSO::get_row_op_stamp). It is updated from the first modified row on. Only the
+     last block starting at each row is kept. */
+  struct DualBlock
+  {
+    vector<enumf> mut, rdiag;
+    vector<long> stamps;
+    long normexp;
+  };
+  std::map<int, DualBlock> dual_blocks;  // by first row
 
   vector<enumf> pruning_bounds;
   enumf maxdist;
-  vector<FT> fx;
 
+  void load_dual_gso(int first, long normexp);
+  void enumerate_converted(FT &fmaxdist, long fmaxdistexpo, long normexp,
+                           const vector<enumxt> &subtree, bool solvingsvp, bool subtree_reset);
   void prepare_enumeration(const vector<enumxt> &subtree, bool solvingsvp, bool subtree_reset);
 
-  void do_enumerate();
+  void do_enumerate(bool walk_path = true);
+
+  /* parallel enumeration */
+  void enumerate_parallel();
+  void split_subtrees(int levels, std::deque<Subtree> &subtrees);
+  void enumerate_subtrees(const EnumerationDyn<FT, N> &master, unsigned int prec);
+  bool next_subtree(Subtree &subtree);
+  void enumerate_subtree(const Subtree &subtree);
+  Subtree next_siblings(int level);
+  void update_shared_maxdist();
+  virtual void poll();
+
+  /* enumeration with checkpoints */
+  void enumerate_checkpointed(long normexp);
+  void write_checkpoint();
+  bool read_checkpoint();
+
+  /* CVP resets */
+  void prepare_resets();
+  void load_reset_data(const EnumerationDyn<FT, N> &master);
+  bool enumerate_reset(const ResetJob &job, enumf bound, ResetResult &result);
+  void enumerate_reset_parallel();
+  void run_resets(ResetState &state, unsigned int prec);
+  void apply_reset_results();
+  static void lower_reset_bound(ResetState &state, enumf bound);
 
   void set_bounds();
+  enumf solution_dist() const;
   void reset(enumf cur_dist, int cur_depth);
   virtual void process_solution(enumf newmaxdist);
   virtual void process_subsolution(int offset, enumf newdist);
@@ -70,7 +419,9 @@ template <typename FT> class Enumeration
 public:
   Enumeration(MatGSO<Integer, FT> &gso, Evaluator<FT> &evaluator,
               const vector<int> &max_indices = vector<int>())
-      : _gso(gso), _evaluator(evaluator), _max_indices(max_indices), enumdyn(nullptr)
+      : _gso(gso), _evaluator(evaluator), _max_indices(max_indices), _threads(1),
+        _checkpoint_interval(ENUM_CHECKPOINT_INTERVAL), _resume_checkpoint(false),
+        _stop_flag(nullptr), _float_levels(0), _detailed_stats(false)
   {
   }
 
@@ -80,35 +431,214 @@ public:
                  const vector<enumf> &pruning = vector<enumf>(), bool dual = false,
                  bool subtree_reset = false)
   {
-    // check for external enumerator and use that
-    if (get_external_enumerator() != nullptr && subtree.empty() && target_coord.empty())
+    // check for an external enumerator accepting the instance and use the one of highest priority
+    int d = (last == -1 ? _gso.d : last) - first;
+    if (has_external_enumerator(d, dual, _evaluator.findsubsols) && subtree.empty() &&
+        target_coord.empty() && _checkpoint_file.empty() && _stop_flag == nullptr)
     {
+      auto start = start_time();
       if (enumext.get() == nullptr)
         enumext.reset(new ExternalEnumeration<FT>(_gso, _evaluator));
       if (enumext->enumerate(first, last, fmaxdist, fmaxdistexpo, pruning, dual))
       {
-        _nodes = enumext->get_nodes();
+        _nodes         = enumext->get_nodes();
+        _stats         = EnumerationStats();
+        _stats.seconds = elapsed_seconds(start);
+        _stats.backend = enumext->get_backend();
         return;
       }
     }
     // if external enumerator is not available, not possible or when it fails then fall through to
-    // fplll enumeration
-    if (enumdyn.get() == nullptr)
-      enumdyn.reset(new EnumerationDyn<FT>(_gso, _evaluator, _max_indices));
-    enumdyn->enumerate(first, last, fmaxdist, fmaxdistexpo, target_coord, subtree, pruning, dual,
-                       subtree_reset);
-    _nodes = enumdyn->get_nodes();
+    // fplll enumeration, using the smallest kernel which fits the dimension
+#if FPLLL_MAX_ENUM_DIMENSION > 32
+    if (d < 32)
+      return enumerate_dyn(enumdyn32, first, last, fmaxdist, fmaxdistexpo, target_coord, subtree,
+                           pruning, dual, subtree_reset);
+#endif
+#if FPLLL_MAX_ENUM_DIMENSION > 48
+    if (d < 48)
+      return enumerate_dyn(enumdyn48, first, last, fmaxdist, fmaxdistexpo, target_coord, subtree,
+                           pruning, dual, subtree_reset);
+#endif
+#if FPLLL_MAX_ENUM_DIMENSION > 64
+    if (d < 64)
+      return enumerate_dyn(enumdyn64, first, last, fmaxdist, fmaxdistexpo, target_coord, subtree,
+                           pruning, dual, subtree_reset);
+#endif
+#if FPLLL_MAX_ENUM_DIMENSION > 96
+    if (d < 96)
+      return enumerate_dyn(enumdyn96, first, last, fmaxdist, fmaxdistexpo, target_coord, subtree,
+                           pruning, dual, subtree_reset);
+#endif
+    enumerate_dyn(enumdyn, first, last, fmaxdist, fmaxdistexpo, target_coord, subtree, pruning,
+                  dual, subtree_reset);
   }
 
   inline uint64_t get_nodes() const { return _nodes; }
 
+  /**
+   * Number of nodes visited at each level by the last enumeration, the root of the tree is the last
+   * level. Empty without detailed statistics or if the enumeration was done by an external
+   * enumerator.
+   */
+  inline const vector<uint64_t> &get_level_nodes() const { return _stats.level_nodes; }
+
+  /**
+   * Statistics of the last enumeration. Only the time is known if the enumeration was done by an
+   * external enumerator.
+   */
+  inline const EnumerationStats &get_stats() const { return _stats; }
+
+  /**
+   * Detailed statistics: the nodes of each level of the fplll enumeration are counted (see
+   * EnumerationDyn::set_level_stats) and the enumeration is timed. Disabled by default, the
+   * statistics are then the number of solutions and subsolutions and the backend.
+   */
+  void set_detailed_stats(bool enable) { _detailed_stats = enable; }
+
+  /** Number of threads used by the fplll enumeration (see EnumerationDyn::set_threads). */
+  void set_threads(unsigned int threads) { _threads = max(threads, 1u); }
+
+  /**
+   * Checkpoints of the fplll enumeration (see EnumerationDyn::set_checkpoint), the external
+   * enumerator is not used when they are enabled.
+   */
+  void set_checkpoint(const string &filename, uint64_t interval = ENUM_CHECKPOINT_INTERVAL,
+                      bool resume = false)
+  {
+    _checkpoint_file     = filename;
+    _checkpoint_interval = interval;
+    _resume_checkpoint   = resume;
+  }
+
+  /**
+   * Stop flag of the fplll enumeration (see EnumerationDyn::set_stop_flag), the external
+   * enumerator is not used when it is set.
+   */
+  void set_stop_flag(const std::atomic<bool> *stop) { _stop_flag = stop; }
+
+  /**
+   * Levels of the fplll enumeration computed in float (see EnumerationDyn::set_float_levels), the
+   * external enumerator ignores it.
+   */
+  void set_float_levels(int levels) { _float_levels = levels; }
+
 private:
   MatGSO<Integer, FT> &_gso;
   Evaluator<FT> &_evaluator;
   vector<int> _max_indices;
   std::unique_ptr<EnumerationDyn<FT>> enumdyn;
+#if FPLLL_MAX_ENUM_DIMENSION > 32
+  std::unique_ptr<EnumerationDyn<FT, 32>> enumdyn32;
+#endif
+#if FPLLL_MAX_ENUM_DIMENSION > 48
+  std::unique_ptr<EnumerationDyn<FT, 48>> enumdyn48;
+#endif
+#if FPLLL_MAX_ENUM_DIMENSION > 64
+  std::unique_ptr<EnumerationDyn<FT, 64>> enumdyn64;
+#endif
+#if FPLLL_MAX_ENUM_DIMENSION > 96
+  std::unique_ptr<EnumerationDyn<FT, 96>> enumdyn96;
+#endif
   std::unique_ptr<ExternalEnumeration<FT>> enumext;
   uint64_t _nodes;
+  EnumerationStats _stats;
+  unsigned int _threads;
+  string _checkpoint_file;
+  uint64_t _checkpoint_interval;
+  bool _resume_checkpoint;
+  const std::atomic<bool> *_stop_flag;
+  int _float_levels;
+  bool _detailed_stats;
+
+  /* the clock is only read with detailed statistics */
+  std::chrono::steady_clock::time_point start_time() const
+  {
+    return _detailed_stats ? std::chrono::steady_clock::now()
+                           : std::chrono::steady_clock::time_point();
+  }
+  double elapsed_seconds(std::chrono::steady_clock::time_point start) const
+  {
+    if (!_detailed_stats)
+      return 0.0;
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  template <int N>
+  void enumerate_dyn(std::unique_ptr<EnumerationDyn<FT, N>> &enumobj, int first, int last,
+                     FT &fmaxdist, long fmaxdistexpo, const vector<FT> &target_coord,
+                     const vector<enumxt> &subtree, const vector<enumf> &pruning, bool dual,
+                     bool subtree_reset)
+  {
+    auto start = start_time();
+    if (enumobj.get() == nullptr)
+      enumobj.reset(new EnumerationDyn<FT, N>(_gso, _evaluator, _max_indices));
+    enumobj->set_threads(_threads);
+    enumobj->set_checkpoint(_checkpoint_file, _checkpoint_interval, _resume_checkpoint);
+    enumobj->set_stop_flag(_stop_flag);
+    enumobj->set_float_levels(_float_levels);
+    enumobj->set_level_stats(_detailed_stats);
+    enumobj->enumerate(first, last, fmaxdist, fmaxdistexpo, target_coord, subtree, pruning, dual,
+                       subtree_reset);
+    _stats.seconds = elapsed_seconds(start);
+    _nodes         = enumobj->get_nodes();
+    _stats.level_nodes.resize(_detailed_stats ? (last == -1 ? _gso.d : last) - first : 0);
+    for (size_t i = 0; i < _stats.level_nodes.size(); ++i)
+      _stats.level_nodes[i] = enumobj->get_nodes(i);
+    _stats.solutions    = enumobj->get_solutions();
+    _stats.subsolutions = enumobj->get_subsolutions();
+  }
+};
+
+/**
+ * Enumeration of many independent blocks of a basis, e.g. for the preprocessing or slide reduction
+ * passes. The GSO data of all blocks is converted to enumf once, then the jobs are enumerated one
+ * after the other or concurrently (see set_threads()). Each thread reuses its enumeration objects
+ * for all the jobs it runs.
+ */
+template <typename FT> class BatchEnumeration
+{
+public:
+  BatchEnumeration(MatGSO<Integer, FT> &gso) : _gso(gso), _threads(1), _nodes(0) {}
+
+  /**
+   * Enumerates all jobs. The GSO object must be up to date on the rows of the jobs and must not be
+   * modified while the jobs run.
+   */
+  void enumerate(vector<EnumerationJob<FT>> &jobs);
+
+  /**
+   * Same as enumerate(jobs) with GSO data converted before by convert_gso(), which must cover the
+   * rows of all jobs. The conversion can then be shared by several batches of the same basis.
+   */
+  void enumerate(const EnumerationGSOData &gso_data, vector<EnumerationJob<FT>> &jobs);
+
+  /** Converts the GSO data of the rows [gso_data.first, gso_data.last) for the enumeration. */
+  void convert_gso(EnumerationGSOData &gso_data);
+
+  /** Total number of nodes visited by the jobs of the last call to enumerate(). */
+  inline uint64_t get_nodes() const { return _nodes; }
+
+  /** Number of jobs run concurrently, each job is enumerated by a single thread. */
+  void set_threads(unsigned int threads) { _threads = max(threads, 1u); }
+  inline unsigned int get_threads() const { return _threads; }
+
+private:
+  MatGSO<Integer, FT> &_gso;
+  unsigned int _threads;
+  uint64_t _nodes;
+
+  void enumerate_jobs(const EnumerationGSOData &gso_data, vector<EnumerationJob<FT>> &jobs,
+                      std::atomic<size_t> &next_job, unsigned int prec);
+
+  template <int N>
+  void enumerate_job(std::unique_ptr<EnumerationDyn<FT, N>> &enumobj,
+                     const EnumerationGSOData &gso_data, EnumerationJob<FT> &job)
+  {
+    if (enumobj.get() == nullptr)
+      enumobj.reset(new EnumerationDyn<FT, N>(_gso, job.evaluator));
+    enumobj->enumerate(gso_data, job);
+  }
 };
 
 FPLLL_END_NAMESPACE
@@ -24,19 +24,35 @@
 #include <array>
 #include <cfenv>
 #include <cmath>
+#include <numeric>
 #include <vector>
 
 FPLLL_BEGIN_NAMESPACE
 
-inline void roundto(int &dest, const double &src) { dest = (int)round(src); }
-inline void roundto(double &dest, const double &src) { dest = round(src); }
-
 /* config */
 #define FPLLL_WITH_RECURSIVE_ENUM 1
 #define MAXTEMPLATEDDIMENSION 80  // unused
 //#define FORCE_ENUM_INLINE // not recommended
 /* end config */
 
+/* The recursive enumeration is compiled a second time for AVX2 and FMA if the compiler supports
+   it, the kernel is then chosen at runtime according to the CPU. All member functions it calls
+   take the avx2 flag as template argument, and the functions it shares with the rest of the
+   library are always inlined, so that none of them is emitted by both kernels under the same name:
+   the linker would keep one of the two copies for both. Unoptimized builds leave this out, since
+   the inline functions of the standard library, e.g. std::array::operator[], are not inlined
+   there. */
+#if defined(FPLLL_WITH_ENUM_AVX2) && defined(FPLLL_WITH_RECURSIVE_ENUM) && defined(__OPTIMIZE__)
+#define FPLLL_ENUM_AVX2_KERNEL 1
+#endif
+
+/**
+ * Enables or disables the enumeration kernel compiled for AVX2, which is enabled by default.
+ * Returns true if this kernel is compiled and supported by the CPU, it is then used by the next
+ * enumerations if enabled. This is meant to compare the two kernels.
+ */
+bool set_enum_avx2_kernel(bool enable);
+
 #ifndef __has_attribute
 #define __has_attribute(x) 0  // Compatibility with non - GCC/clang compilers.
 #endif
@@ -46,18 +62,50 @@ inline void roundto(double &dest, const double &src) { dest = round(src); }
 #define ALWAYS_INLINE
 #endif
 
+/* rint is inlined by the compiler unlike round, the enumeration sets the rounding mode to nearest
+   (see save_rounding()) */
+inline void roundto(int &dest, const double &src) ALWAYS_INLINE;
+inline void roundto(double &dest, const double &src) ALWAYS_INLINE;
+inline void roundto(int &dest, const double &src) { dest = (int)lrint(src); }
+inline void roundto(double &dest, const double &src) { dest = rint(src); }
+
 #ifndef FORCE_ENUM_INLINE
 #define ENUM_ALWAYS_INLINE
 #else
 #define ENUM_ALWAYS_INLINE ALWAYS_INLINE
 #endif
 
-class EnumerationBase
+/* enum_levels<0, 1, ..., n - 1>, used to build the dispatch table of the recursive enumeration */
+template <int... kk> struct enum_levels
+{
+};
+template <int n, int... kk> struct make_enum_levels : make_enum_levels<n - 1, n - 1, kk...>
+{
+};
+template <int... kk> struct make_enum_levels<0, kk...>
+{
+  typedef enum_levels<kk...> type;
+};
+
+/* Enumeration kernel for dimensions d < N. All arrays have size N, so that for small N (see
+   Enumeration) the enumeration data is compact and the row offsets are compile-time constants. */
+template <int N = FPLLL_MAX_ENUM_DIMENSION> class EnumerationBase
 {
 public:
-  static const int maxdim = FPLLL_MAX_ENUM_DIMENSION;
+  static const int maxdim = N;
+
+  /* level at which the recursive enumeration calls poll() */
+  static const int poll_level = 8;
 
-  inline uint64_t get_nodes() const { return nodes; }
+  EnumerationBase() : float_levels(0), level_stats(false), polling(false) { nodes.fill(0); }
+
+  inline uint64_t get_nodes() const
+  {
+    return std::accumulate(nodes.begin(), nodes.end(), uint64_t(0));
+  }
+  /** number of nodes visited at the given level, the root of the tree is at level d - 1, only
+      counted if level_stats is set (see EnumerationDyn::set_level_stats()) */
+  inline uint64_t get_nodes(int level) const { return nodes[level]; }
   virtual ~EnumerationBase() {}
 
 protected:
@@ -76,6 +124,12 @@ protected:
   array<enumf, maxdim> center_partsum;
   array<int, maxdim> center_partsum_begin;
 
+  /* mixed precision (see EnumerationDyn::set_float_levels()): the levels below float_levels use
+     the rows of mut_f and center_partsums_f instead of mut and center_partsums. These rows are
+     only allocated for these levels, and only read by the kernel with float_centers set. */
+  int float_levels;
+  vector<array<float, maxdim>> mut_f, center_partsums_f;
+
   /* enumeration data for each level */
   array<enumf, maxdim> partdist, center, alpha;
   array<enumxt, maxdim> x, dx, ddx;
@@ -88,42 +142,155 @@ protected:
   int k, k_max;
   bool finished;
 
-  /* nodes count */
-  uint64_t nodes;
+  /* nodes count of each level if level_stats is set, otherwise they are all counted in nodes[0]:
+     only the kernel instantiated with count_levels counts the nodes of each level */
+  array<uint64_t, maxdim> nodes;
+  bool level_stats;
+  inline int node_level(int kk) const { return level_stats ? kk : 0; }
+
+  /* if set, poll() is called each time the subtree of a node at level poll_level is finished */
+  bool polling;
 
-  template <int kk, int kk_start, bool dualenum, bool findsubsols, bool enable_reset> struct opts
+  /* count_levels is set for the enumerations with level_stats, so that the others keep a single
+     node counter */
+  template <int kk, int kk_start, bool dualenum, bool findsubsols, bool enable_reset,
+            bool float_centers, bool avx2, bool count_levels>
+  struct opts
   {
   };
 
   /* need templated function argument for support of integer specialization for kk==-1 */
-  template <int kk, int kk_start, bool dualenum, bool findsubsols, bool enable_reset>
-  inline void enumerate_recursive(opts<kk, kk_start, dualenum, findsubsols, enable_reset>)
+  template <int kk, int kk_start, bool dualenum, bool findsubsols, bool enable_reset,
+            bool float_centers, bool avx2, bool count_levels>
+  inline void enumerate_recursive(
+      opts<kk, kk_start, dualenum, findsubsols, enable_reset, float_centers, avx2, count_levels>)
       ENUM_ALWAYS_INLINE;
-  template <int kk_start, bool dualenum, bool findsubsols, bool enable_reset>
-  inline void enumerate_recursive(opts<-1, kk_start, dualenum, findsubsols, enable_reset>)
+  template <int kk_start, bool dualenum, bool findsubsols, bool enable_reset, bool float_centers,
+            bool avx2, bool count_levels>
+  inline void enumerate_recursive(
+      opts<-1, kk_start, dualenum, findsubsols, enable_reset, float_centers, avx2, count_levels>)
   {
   }
 
   /* simple wrapper with no function argument as helper for dispatcher */
-  template <int kk, bool dualenum, bool findsubsols, bool enable_reset>
+  template <int kk, bool dualenum, bool findsubsols, bool enable_reset, bool float_centers,
+            bool avx2, bool count_levels>
   void enumerate_recursive_wrapper()
   {
     // kk < maxdim-1:
     // kk < kk_end                         (see enumerate_loop(), enumerate_base.cpp)
     // kk_end = d - subtree.size() <= d    (see prepare_enumeration(), enumerate.cpp)
     // d < maxdim                          (see enumerate(), enumerate.cpp)
-    enumerate_recursive(
-        opts<(kk < (maxdim - 1) ? kk : -1), 0, dualenum, findsubsols, enable_reset>());
+    enumerate_recursive(opts<(kk < (maxdim - 1) ? kk : -1), 0, dualenum, findsubsols, enable_reset,
+                             float_centers, avx2, count_levels>());
+  }
+
+  template <bool dualenum, bool findsubsols, bool enable_reset, bool float_centers, bool avx2,
+            bool count_levels, int... levels>
+  inline void enumerate_recursive_dispatch(int kk, enum_levels<levels...>)
+  {
+    typedef void (EnumerationBase::*enum_recur_type)();
+    static const enum_recur_type lookup[] = {
+        &EnumerationBase::enumerate_recursive_wrapper<levels, dualenum, findsubsols, enable_reset,
+                                                      float_centers, avx2, count_levels>...};
+    (this->*lookup[kk])();
+  }
+
+  template <bool dualenum, bool findsubsols, bool enable_reset, bool float_centers, bool avx2,
+            bool count_levels>
+  inline void enumerate_recursive_dispatch(int kk)
+  {
+    enumerate_recursive_dispatch<dualenum, findsubsols, enable_reset, float_centers, avx2,
+                                 count_levels>(kk, typename make_enum_levels<maxdim - 1>::type());
   }
 
-  template <bool dualenum, bool findsubsols, bool enable_reset>
-  inline void enumerate_recursive_dispatch(int kk);
+  /* the recursive enumeration compiled for AVX2 and FMA (see enumerate_base_avx2.cpp) */
+  template <bool dualenum, bool findsubsols, bool enable_reset, bool float_centers>
+  void enumerate_recursive_avx2(int kk);
 
-  template <bool dualenum, bool findsubsols, bool enable_reset> void enumerate_loop();
+  /* float_centers is set for the enumerations with float levels, so that the others do not check
+     the level of each center */
+  template <bool dualenum, bool findsubsols, bool enable_reset, bool float_centers>
+  void enumerate_loop();
 
   virtual void reset(enumf, int) = 0;
   virtual void process_solution(enumf newmaxdist) = 0;
   virtual void process_subsolution(int offset, enumf newdist) = 0;
+  /* not inline, so that the AVX2 kernel does not emit it (see enumerate_base.cpp) */
+  virtual void poll();
+
+  /* Sets partsums[j] = partsums[j + 1] - coord[j] * mu[j] for j = jmax, ..., jmin, keeping the
+     running sum in a register. */
+  template <bool avx2, typename F, typename T>
+  ALWAYS_INLINE static inline void update_center_partsums(F *partsums, const F *mu, const T *coord,
+                                                          int jmax, int jmin)
+  {
+    F partsum = partsums[jmax + 1];
+    for (int j = jmax; j >= jmin; --j)
+    {
+      partsum -= F(coord[j]) * mu[j];
+      partsums[j] = partsum;
+    }
+  }
+
+  /* Updates the partial sums of level kk - 1 from center_partsum_begin[kk] down to kk and sets
+     center[kk - 1], in float if float_centers is set and kk - 1 < float_levels. It is called once
+     per node, hence it is always inlined like the functions it calls. */
+  template <bool dualenum, bool float_centers, bool avx2>
+  ALWAYS_INLINE inline void update_center(int kk)
+  {
+    if (float_centers && kk - 1 < float_levels)
+    {
+      if (dualenum)
+        update_center_partsums<avx2>(center_partsums_f[kk - 1].data(), mut_f[kk - 1].data(),
+                                     &alpha[0], center_partsum_begin[kk], kk);
+      else
+        update_center_partsums<avx2>(center_partsums_f[kk - 1].data(), mut_f[kk - 1].data(),
+                                     &x[0], center_partsum_begin[kk], kk);
+      center[kk - 1] = center_partsums_f[kk - 1][kk];
+    }
+    else
+    {
+      if (dualenum)
+        update_center_partsums<avx2>(center_partsums[kk - 1], mut[kk - 1], &alpha[0],
+                                     center_partsum_begin[kk], kk);
+      else
+        update_center_partsums<avx2>(center_partsums[kk - 1], mut[kk - 1], &x[0],
+                                     center_partsum_begin[kk], kk);
+      center[kk - 1] = center_partsums[kk - 1][kk];
+    }
+  }
+
+  /* Same as update_center() when only the coordinate of level kk has changed. */
+  template <bool dualenum, bool float_centers, bool avx2>
+  ALWAYS_INLINE inline void update_center_sibling(int kk)
+  {
+    enumf coord = dualenum ? alpha[kk] : x[kk];
+    if (float_centers && kk - 1 < float_levels)
+    {
+      center_partsums_f[kk - 1][kk] =
+          center_partsums_f[kk - 1][kk + 1] - float(coord) * mut_f[kk - 1][kk];
+      center[kk - 1] = center_partsums_f[kk - 1][kk];
+    }
+    else
+    {
+      center_partsums[kk - 1][kk] = center_partsums[kk - 1][kk + 1] - coord * mut[kk - 1][kk];
+      center[kk - 1]              = center_partsums[kk - 1][kk];
+    }
+  }
+
+  /* Converts the rows of mut below float_levels to float. */
+  void prepare_float_levels()
+  {
+    if (mut_f.size() < (size_t)float_levels)
+    {
+      mut_f.resize(float_levels);
+      center_partsums_f.resize(float_levels);
+    }
+    for (int i = 0; i < float_levels; ++i)
+      for (int j = i + 1; j < d; ++j)
+        mut_f[i][j] = float(mut[i][j]);
+  }
 
   int rounding_backup;
   void save_rounding()
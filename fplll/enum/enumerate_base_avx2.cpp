@@ -0,0 +1,66 @@
+/* Copyright (C) 2008-2011 Xavier Pujol
+   (C) 2015 Michael Walter.
+   (C) 2016 Marc Stevens. (generic improvements, auxiliary solutions, subsolutions)
+   (C) 2016 Guillaume Bonnoron. (CVP improvements)
+
+   This file is part of fplll. fplll is free software: you
+   can redistribute it and/or modify it under the terms of the GNU Lesser
+   General Public License as published by the Free Software Foundation,
+   either version 2.1 of the License, or (at your option) any later version.
+
+   fplll is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with fplll. If not, see <http://www.gnu.org/licenses/>. */
+
+/* This file is compiled with -mavx2 -mfma (see AVX2_CXXFLAGS in configure.ac). The kernel is
+   instantiated with avx2 = true, so that its symbols differ from the generic kernel. */
+
+#include "enumerate_recursive.h"
+
+FPLLL_BEGIN_NAMESPACE
+
+#ifdef FPLLL_ENUM_AVX2_KERNEL
+
+#if !defined(__AVX2__) || !defined(__FMA__)
+#error "enumerate_base_avx2.cpp must be compiled with AVX2_CXXFLAGS"
+#endif
+
+template <int N>
+template <bool dualenum, bool findsubsols, bool enable_reset, bool float_centers>
+void EnumerationBase<N>::enumerate_recursive_avx2(int kk)
+{
+  enumerate_recursive_dispatch<dualenum, findsubsols, enable_reset, float_centers, true, false>(
+      kk);
+}
+
+#define ENUM_INSTANTIATE_AVX2(N)                                                                   \
+  template void EnumerationBase<N>::enumerate_recursive_avx2<false, false, true, false>(int);      \
+  template void EnumerationBase<N>::enumerate_recursive_avx2<false, true, true, false>(int);       \
+  template void EnumerationBase<N>::enumerate_recursive_avx2<false, false, false, false>(int);     \
+  template void EnumerationBase<N>::enumerate_recursive_avx2<false, false, false, true>(int);      \
+  template void EnumerationBase<N>::enumerate_recursive_avx2<false, true, false, false>(int);      \
+  template void EnumerationBase<N>::enumerate_recursive_avx2<true, false, false, false>(int);      \
+  template void EnumerationBase<N>::enumerate_recursive_avx2<true, true, false, false>(int);
+
+ENUM_INSTANTIATE_AVX2(FPLLL_MAX_ENUM_DIMENSION)
+
+#if FPLLL_MAX_ENUM_DIMENSION > 32
+ENUM_INSTANTIATE_AVX2(32)
+#endif
+#if FPLLL_MAX_ENUM_DIMENSION > 48
+ENUM_INSTANTIATE_AVX2(48)
+#endif
+#if FPLLL_MAX_ENUM_DIMENSION > 64
+ENUM_INSTANTIATE_AVX2(64)
+#endif
+#if FPLLL_MAX_ENUM_DIMENSION > 96
+ENUM_INSTANTIATE_AVX2(96)
+#endif
+
+#endif
+
+FPLLL_END_NAMESPACE
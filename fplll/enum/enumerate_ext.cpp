@@ -15,24 +15,185 @@
    along with fplll. If not, see <http://www.gnu.org/licenses/>. */
 
 #include "enumerate_ext.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <mutex>
 
 FPLLL_BEGIN_NAMESPACE
 
+/* registry of the external enumerators, in the order of registration */
+static std::mutex extenum_mutex;
+static vector<ExternalEnumerator> extenum_backends;
+
+/* Primal SVP instance of dimension d following the geometric series assumption, with pseudo-random
+   mu, on which the backends are compared: mu[i * d + j] is mu(i, j). */
+static void benchmark_instance(int d, vector<enumf> &mu, vector<enumf> &rdiag)
+{
+  mu.assign(d * d, 0.0);
+  rdiag.resize(d);
+  uint64_t seed = 1;
+  for (int i = 0; i < d; ++i)
+  {
+    rdiag[i] = std::pow(0.9, i);
+    for (int j = 0; j < i; ++j)
+    {
+      seed          = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      mu[i * d + j] = double(seed >> 11) / double(1ULL << 53) - 0.5;
+    }
+  }
+}
+
+/* Nodes per second of `extenum` on the benchmark instance of dimension d. The radius is not
+   lowered by the solutions, and the enumeration is stopped at the first solution found after
+   EXTENUM_BENCHMARK_SECONDS. 0 if the backend does not enumerate it. */
+static double benchmark_external_enumerator(const std::function<extenum_fc_enumerate> &extenum,
+                                            int d)
+{
+  vector<enumf> mu, rdiag;
+  benchmark_instance(d, mu, rdiag);
+
+  auto set_config = [&](enumf *cfg_mu, size_t mudim, bool mutranspose, enumf *cfg_rdiag,
+                        enumf *pruning) {
+    for (int i = 0; i < d; ++i)
+    {
+      cfg_rdiag[i] = rdiag[i];
+      pruning[i]   = 1.0;
+      for (int j = 0; j < d; ++j)
+      {
+        if (mutranspose)
+          cfg_mu[i * mudim + j] = mu[j * d + i];  // mu(j, i)
+        else
+          cfg_mu[j * mudim + i] = mu[j * d + i];
+      }
+    }
+  };
+  auto start    = std::chrono::steady_clock::now();
+  auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                              std::chrono::duration<double>(EXTENUM_BENCHMARK_SECONDS));
+  enumf maxdist    = rdiag[0];
+  auto process_sol = [&maxdist, deadline](enumf, enumf *) {
+    if (maxdist > 0.0 && std::chrono::steady_clock::now() >= deadline)
+      maxdist = 0.0;
+    return maxdist;
+  };
+  auto process_subsol = [](enumf, enumf *, int) {};
+
+  uint64_t nodes = extenum(d, rdiag[0], set_config, process_sol, process_subsol, false, false);
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  if (nodes == ~uint64_t(0))
+    return 0.0;
+  return nodes / std::max(seconds, 1e-9);
+}
+
+void register_external_enumerator(const std::string &name,
+                                  std::function<extenum_fc_enumerate> extenum, int priority,
+                                  int min_dim, int max_dim, bool dual, bool findsubsols)
+{
+  std::lock_guard<std::mutex> lock(extenum_mutex);
+  extenum_backends.erase(std::remove_if(extenum_backends.begin(), extenum_backends.end(),
+                                        [&name](const ExternalEnumerator &registered) {
+                                          return registered.name == name;
+                                        }),
+                         extenum_backends.end());
+  if (extenum == nullptr)
+    return;
+  ExternalEnumerator backend;
+  backend.name        = name;
+  backend.enumerate   = extenum;
+  backend.priority    = priority;
+  backend.min_dim     = min_dim;
+  backend.max_dim     = max_dim;
+  backend.dual        = dual;
+  backend.findsubsols = findsubsols;
+  extenum_backends.push_back(backend);
+}
+
+void benchmark_external_enumerators(int min_dim, int max_dim)
+{
+  // the backends are run without the lock, and their speeds are only recorded afterwards
+  int d = (min_dim + max_dim) / 2;
+  vector<ExternalEnumerator> backends = get_external_enumerators();
+  vector<double> speeds(backends.size(), 0.0);
+  for (size_t i = 0; i < backends.size(); ++i)
+  {
+    if (backends[i].accepts(d, false, false))
+      speeds[i] = benchmark_external_enumerator(backends[i].enumerate, d);
+  }
+
+  std::lock_guard<std::mutex> lock(extenum_mutex);
+  for (size_t i = 0; i < backends.size(); ++i)
+  {
+    if (speeds[i] == 0.0)
+      continue;
+    for (ExternalEnumerator &backend : extenum_backends)
+    {
+      if (backend.name == backends[i].name)
+        backend.benchmarks.push_back({min_dim, max_dim, speeds[i]});
+    }
+  }
+}
+
+vector<ExternalEnumerator> get_external_enumerators()
+{
+  std::lock_guard<std::mutex> lock(extenum_mutex);
+  return extenum_backends;
+}
+
+bool has_external_enumerator(int dim, bool dual, bool findsubsols)
+{
+  std::lock_guard<std::mutex> lock(extenum_mutex);
+  for (const ExternalEnumerator &backend : extenum_backends)
+  {
+    if (backend.accepts(dim, dual, findsubsols))
+      return true;
+  }
+  return false;
+}
+
 // set & get external enumerator (nullptr => disabled)
-std::function<extenum_fc_enumerate> fplll_extenum = nullptr;
 void set_external_enumerator(std::function<extenum_fc_enumerate> extenum)
 {
-  fplll_extenum = extenum;
+  register_external_enumerator(EXTENUM_DEFAULT_BACKEND, extenum, EXTENUM_DEFAULT_BACKEND_PRIORITY);
+}
+std::function<extenum_fc_enumerate> get_external_enumerator()
+{
+  std::lock_guard<std::mutex> lock(extenum_mutex);
+  for (const ExternalEnumerator &backend : extenum_backends)
+  {
+    if (backend.name == EXTENUM_DEFAULT_BACKEND)
+      return backend.enumerate;
+  }
+  return nullptr;
+}
+
+/* The backends accepting the instance, by decreasing priority, then by decreasing measured speed
+   on its dimension, then in the order of their registration. */
+static vector<ExternalEnumerator> select_external_enumerators(int dim, bool dual, bool findsubsols)
+{
+  vector<ExternalEnumerator> selected;
+  {
+    std::lock_guard<std::mutex> lock(extenum_mutex);
+    for (const ExternalEnumerator &backend : extenum_backends)
+    {
+      if (backend.accepts(dim, dual, findsubsols))
+        selected.push_back(backend);
+    }
+  }
+  std::stable_sort(selected.begin(), selected.end(),
+                   [dim](const ExternalEnumerator &a, const ExternalEnumerator &b) {
+                     if (a.priority != b.priority)
+                       return a.priority > b.priority;
+                     return a.get_nodes_per_sec(dim) > b.get_nodes_per_sec(dim);
+                   });
+  return selected;
 }
-std::function<extenum_fc_enumerate> get_external_enumerator() { return fplll_extenum; }
 
 template <typename FT>
 bool ExternalEnumeration<FT>::enumerate(int first, int last, FT &fmaxdist, long fmaxdistexpo,
                                         const vector<enumf> &pruning, bool dual)
 {
   using namespace std::placeholders;
-  if (fplll_extenum == nullptr)
-    return false;
   if (last == -1)
     last = _gso.d;
 
@@ -40,7 +201,11 @@ bool ExternalEnumeration<FT>::enumerate(int first, int last, FT &fmaxdist, long
   _dual    = dual;
   _pruning = pruning;
   _d       = last - _first;
-  _fx.resize(_d);
+
+  vector<ExternalEnumerator> backends =
+      select_external_enumerators(_d, _dual, _evaluator.findsubsols);
+  if (backends.empty())
+    return false;
 
   FPLLL_CHECK(_pruning.empty() || int(_pruning.size()) == _d,
               "ExternalEnumeration: non-empty pruning vector dimension does not match");
@@ -55,18 +220,29 @@ bool ExternalEnumeration<FT>::enumerate(int first, int last, FT &fmaxdist, long
   }
   fmaxdistnorm.mul_2si(fmaxdist, dual ? _normexp - fmaxdistexpo : fmaxdistexpo - _normexp);
 
-  _maxdist = fmaxdistnorm.get_d(GMP_RNDU);
   _evaluator.set_normexp(_normexp);
 
-  // clang-format off
-  _nodes = fplll_extenum(_d, _maxdist,
-               std::bind(&ExternalEnumeration<FT>::callback_set_config, this, _1, _2, _3, _4, _5),
-               std::bind(&ExternalEnumeration<FT>::callback_process_sol, this, _1, _2),
-               std::bind(&ExternalEnumeration<FT>::callback_process_subsol, this, _1, _2, _3),
-               _dual, _evaluator.findsubsols
-               );
-  // clang-format on
-  return _nodes != ~uint64_t(0);
+  for (const ExternalEnumerator &backend : backends)
+  {
+    _maxdist = fmaxdistnorm.get_d(GMP_RNDU);
+    _backend = backend.name;
+    // clang-format off
+    _nodes = backend.enumerate(_d, _maxdist,
+                 std::bind(&ExternalEnumeration<FT>::callback_set_config, this, _1, _2, _3, _4, _5),
+                 std::bind(&ExternalEnumeration<FT>::callback_process_sol, this, _1, _2),
+                 std::bind(&ExternalEnumeration<FT>::callback_process_subsol, this, _1, _2, _3),
+                 _dual, _evaluator.findsubsols
+                 );
+    // clang-format on
+    if (_nodes != ~uint64_t(0))
+    {
+      _evaluator.sync_solutions();
+      return true;
+    }
+  }
+  _backend.clear();
+  _evaluator.sync_solutions();
+  return false;
 }
 
 template <typename FT>
@@ -124,20 +300,14 @@ void ExternalEnumeration<FT>::callback_set_config(enumf *mu, size_t mudim, bool
 
 template <typename FT> enumf ExternalEnumeration<FT>::callback_process_sol(enumf dist, enumf *sol)
 {
-  for (int i = 0; i < _d; ++i)
-    _fx[i]   = sol[i];
-  _evaluator.eval_sol(_fx, dist, _maxdist);
+  _evaluator.eval_raw_sol(sol, _d, dist, _maxdist);
   return _maxdist;
 }
 
 template <typename FT>
 void ExternalEnumeration<FT>::callback_process_subsol(enumf dist, enumf *subsol, int offset)
 {
-  for (int i = 0; i < offset; ++i)
-    _fx[i]   = 0.0;
-  for (int i = offset; i < _d; ++i)
-    _fx[i]   = subsol[i];
-  _evaluator.eval_sub_sol(offset, _fx, dist);
+  _evaluator.eval_raw_sub_sol(offset, subsol, _d, dist);
 }
 
 template class ExternalEnumeration<FP_NR<double>>;
@@ -22,7 +22,9 @@
 #include <fplll/enum/evaluator.h>
 #include <fplll/gso.h>
 #include <functional>
+#include <limits>
 #include <memory>
+#include <string>
 
 FPLLL_BEGIN_NAMESPACE
 
@@ -77,9 +79,86 @@ typedef uint64_t(extenum_fc_enumerate)(int dim, enumf maxdist,
                                        );
 
 // set & get external enumerator (nullptr => disabled)
+// it is the backend EXTENUM_DEFAULT_BACKEND of the registry below, accepting all instances with
+// the highest priority: it is always tried first
 void set_external_enumerator(std::function<extenum_fc_enumerate> extenum = nullptr);
 std::function<extenum_fc_enumerate> get_external_enumerator();
 
+const char *const EXTENUM_DEFAULT_BACKEND  = "extenum";
+const int EXTENUM_DEFAULT_BACKEND_PRIORITY = std::numeric_limits<int>::max();
+
+/* Time after which the enumeration of a backend is stopped by benchmark_external_enumerators(). */
+const double EXTENUM_BENCHMARK_SECONDS = 0.05;
+
+/** Speed of a backend measured by benchmark_external_enumerators() on a range of dimensions. */
+struct ExternalEnumeratorBenchmark
+{
+  int min_dim, max_dim;
+  double nodes_per_sec;
+};
+
+/**
+ * Enumeration backend of the registry of external enumerators, with the instances it accepts.
+ * CVP is never given to external enumerators: extenum_fc_enumerate has no target.
+ */
+struct ExternalEnumerator
+{
+  std::string name;
+  std::function<extenum_fc_enumerate> enumerate;
+  int priority;          // backends of higher priority are tried first
+  int min_dim, max_dim;  // accepted dimensions
+  bool dual;             // accepts dual enumerations
+  bool findsubsols;      // accepts enumerations with subsolutions
+  // measured by benchmark_external_enumerators(), the latest last
+  vector<ExternalEnumeratorBenchmark> benchmarks;
+
+  bool accepts(int dim, bool dual_enum, bool find_subsols) const
+  {
+    return min_dim <= dim && dim <= max_dim && (dual || !dual_enum) &&
+           (findsubsols || !find_subsols);
+  }
+
+  /** Nodes per second of the latest benchmark of a range containing dim, 0 if none. */
+  double get_nodes_per_sec(int dim) const
+  {
+    for (auto it = benchmarks.rbegin(); it != benchmarks.rend(); ++it)
+    {
+      if (it->min_dim <= dim && dim <= it->max_dim)
+        return it->nodes_per_sec;
+    }
+    return 0.0;
+  }
+};
+
+/**
+ * Registers an enumeration backend for the instances of dimension min_dim to max_dim, with or
+ * without dual enumeration and subsolutions as given. It replaces the backend of the same name,
+ * nullptr removes it. ExternalEnumeration gives each instance to the backend of highest priority
+ * accepting it, the next ones being tried if it returns ~uint64_t(0), and fplll's own enumeration
+ * is used if none of them enumerates it. Backends of the same priority are tried in the order of
+ * their speed on the dimension of the instance if benchmark_external_enumerators() measured it,
+ * the measured ones first, and otherwise in the order of their registration.
+ */
+void register_external_enumerator(const std::string &name,
+                                  std::function<extenum_fc_enumerate> extenum, int priority = 0,
+                                  int min_dim = 1, int max_dim = FPLLL_MAX_ENUM_DIMENSION,
+                                  bool dual = true, bool findsubsols = true);
+
+/**
+ * Measures the speed of the registered backends on the dimensions min_dim to max_dim, which breaks
+ * the ties between backends of the same priority on these dimensions. Each backend accepting the
+ * middle dimension enumerates a primal instance of that dimension for at most
+ * EXTENUM_BENCHMARK_SECONDS. Registering a backend never runs it, this has to be called
+ * explicitly.
+ */
+void benchmark_external_enumerators(int min_dim, int max_dim);
+
+/** The registered backends, in the order of their registration. */
+vector<ExternalEnumerator> get_external_enumerators();
+
+/** true if a registered backend accepts the instance. */
+bool has_external_enumerator(int dim, bool dual = false, bool findsubsols = false);
+
 template <typename FT> class ExternalEnumeration
 {
 public:
@@ -93,6 +172,9 @@ public:
 
   inline uint64_t get_nodes() const { return _nodes; }
 
+  /** name of the backend which did the last enumeration */
+  inline const std::string &get_backend() const { return _backend; }
+
 private:
   void callback_set_config(enumf *mu, size_t mudim, bool mutranspose, enumf *rdiag, enumf *pruning);
 
@@ -105,11 +187,11 @@ private:
   vector<enumf> _pruning;
   long _normexp;
   uint64_t _nodes;
+  std::string _backend;
 
   bool _dual;
   int _d, _first;
   enumf _maxdist;
-  vector<FT> _fx;
 };
 
 FPLLL_END_NAMESPACE
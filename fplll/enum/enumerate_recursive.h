@@ -0,0 +1,140 @@
+/* Copyright (C) 2008-2011 Xavier Pujol
+   (C) 2015 Michael Walter.
+   (C) 2016 Marc Stevens. (generic improvements, auxiliary solutions, subsolutions)
+   (C) 2016 Guillaume Bonnoron. (CVP improvements)
+
+   This file is part of fplll. fplll is free software: you
+   can redistribute it and/or modify it under the terms of the GNU Lesser
+   General Public License as published by the Free Software Foundation,
+   either version 2.1 of the License, or (at your option) any later version.
+
+   fplll is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with fplll. If not, see <http://www.gnu.org/licenses/>. */
+
+/* Recursive enumeration kernel. This file is included by enumerate_base.cpp and by
+   enumerate_base_avx2.cpp, which compiles the same kernel for AVX2 and FMA. */
+
+#ifndef FPLLL_ENUMERATE_RECURSIVE_H
+#define FPLLL_ENUMERATE_RECURSIVE_H
+
+#include "enumerate_base.h"
+
+FPLLL_BEGIN_NAMESPACE
+
+#ifdef FPLLL_WITH_RECURSIVE_ENUM
+template <int N>
+template <int kk, int kk_start, bool dualenum, bool findsubsols, bool enable_reset,
+          bool float_centers, bool avx2, bool count_levels>
+inline void EnumerationBase<N>::enumerate_recursive(
+    opts<kk, kk_start, dualenum, findsubsols, enable_reset, float_centers, avx2, count_levels>)
+{
+  enumf alphak  = x[kk] - center[kk];
+  enumf newdist = partdist[kk] + alphak * alphak * rdiag[kk];
+
+  if (!(newdist <= partdistbounds[kk]))
+    return;
+  ++nodes[count_levels ? kk : 0];
+
+  alpha[kk] = alphak;
+  if (findsubsols && newdist < subsoldists[kk])
+  {
+    subsoldists[kk] = newdist;
+    process_subsolution(kk, newdist);
+  }
+
+  if (kk == 0)
+  {
+    if (newdist > 0.0 || !is_svp)
+      process_solution(newdist);
+  }
+  else if (enable_reset &&
+           kk < reset_depth)  // in CVP, below the max GS vector, we reset the partial distance
+  {
+    reset(newdist, kk);
+    return;
+  }
+  else
+  {
+    partdist[kk - 1] = newdist;
+    update_center<dualenum, float_centers, avx2>(kk);
+    if (center_partsum_begin[kk] > center_partsum_begin[kk - 1])
+      center_partsum_begin[kk - 1] = center_partsum_begin[kk];
+    center_partsum_begin[kk]       = kk;
+    roundto(x[kk - 1], center[kk - 1]);
+    dx[kk - 1] = ddx[kk - 1] = (((int)(center[kk - 1] >= x[kk - 1]) & 1) << 1) - 1;
+  }
+
+  while (true)
+  {
+    FPLLL_TRACE("Level k=" << kk << " dist_k=" << partdist[kk] << " x_k=" << x[kk]
+                           << " newdist=" << newdist << " partdistbounds_k=" << partdistbounds[kk]);
+    enumerate_recursive(opts<kk - 1, kk_start, dualenum, findsubsols, enable_reset, float_centers,
+                             avx2, count_levels>());
+    if (kk == poll_level && polling)
+      poll();
+
+    if (partdist[kk] != 0.0)
+    {
+      x[kk] += dx[kk];
+      ddx[kk] = -ddx[kk];
+      dx[kk]  = ddx[kk] - dx[kk];
+
+      enumf alphak2  = x[kk] - center[kk];
+      enumf newdist2 = partdist[kk] + alphak2 * alphak2 * rdiag[kk];
+      if (!(newdist2 <= partdistbounds[kk]))
+        return;
+      ++nodes[count_levels ? kk : 0];
+      alpha[kk] = alphak2;
+      if (kk == 0)
+      {
+        if (newdist2 > 0.0 || !is_svp)
+          process_solution(newdist2);
+      }
+      else
+      {
+        partdist[kk - 1] = newdist2;
+        update_center_sibling<dualenum, float_centers, avx2>(kk);
+        if (kk > center_partsum_begin[kk - 1])
+          center_partsum_begin[kk - 1] = kk;
+        roundto(x[kk - 1], center[kk - 1]);
+        dx[kk - 1] = ddx[kk - 1] = (((int)(center[kk - 1] >= x[kk - 1]) & 1) << 1) - 1;
+      }
+    }
+    else
+    {
+      ++x[kk];
+
+      enumf alphak2  = x[kk] - center[kk];
+      enumf newdist2 = partdist[kk] + alphak2 * alphak2 * rdiag[kk];
+      if (!(newdist2 <= partdistbounds[kk]))
+        return;
+      ++nodes[count_levels ? kk : 0];
+      alpha[kk] = alphak2;
+      if (kk == 0)
+      {
+        if (newdist2 > 0.0 || !is_svp)
+          process_solution(newdist2);
+      }
+      else
+      {
+        partdist[kk - 1] = newdist2;
+        update_center_sibling<dualenum, float_centers, avx2>(kk);
+        if (kk > center_partsum_begin[kk - 1])
+          center_partsum_begin[kk - 1] = kk;
+        roundto(x[kk - 1], center[kk - 1]);
+        dx[kk - 1] = ddx[kk - 1] = (((int)(center[kk - 1] >= x[kk - 1]) & 1) << 1) - 1;
+      }
+    }
+  }
+}
+
+#endif
+
+FPLLL_END_NAMESPACE
+
+#endif
@@ -272,78 +272,223 @@ bool ExactErrorBoundedEvaluator::get_max_error(Float &max_error, const Float &la
   return true;
 }
 
-void ExactErrorBoundedEvaluator::eval_sol(const FloatVect &new_sol_coord,
-                                          const enumf &new_partial_dist, enumf &max_dist)
+Integer ExactErrorBoundedEvaluator::exact_sol_dist(const FloatVect &sol_coord)
 {
-  int n = matrix.get_cols();
-  Integer new_sol_dist, coord;
-  IntVect new_sol;
+  return exact_subsol_dist(0, sol_coord);
+}
 
-  gen_zero_vect(new_sol, n);
-  new_sol_dist = 0;
+Integer ExactErrorBoundedEvaluator::exact_subsol_dist(int offset, const FloatVect &sol_coord)
+{
+  int n = matrix.get_cols();
+  Integer dist;
 
-  // Computes the distance between x and zero
-  for (int i = 0; i < d; i++)
+  // Computes the distance between x[[offset,d)] and zero
+  sol_vect.resize(n);
+  for (int j = 0; j < n; j++)
+    sol_vect[j] = 0;
+  for (int i = offset; i < d; i++)
   {
-    coord.set_f(new_sol_coord[i]);
+    sol_coord_z.set_f(sol_coord[i]);
+    if (sol_coord_z.sgn() == 0)
+      continue;
     for (int j = 0; j < n; j++)
-      new_sol[j].addmul(coord, matrix(i, j));
-  }
-  for (int i = 0; i < n; i++)
-  {
-    coord = new_sol[i];
-    new_sol_dist.addmul(coord, coord);
+      sol_vect[j].addmul(sol_coord_z, matrix(i, j));
   }
+  dist = 0;
+  for (int j = 0; j < n; j++)
+    dist.addmul(sol_vect[j], sol_vect[j]);
+  return dist;
+}
 
-  if (int_max_dist < 0 || new_sol_dist <= int_max_dist)
+void ExactErrorBoundedEvaluator::process_exact_sol(const Integer &dist, const FloatVect &coord,
+                                                   enumf &max_dist)
+{
+  if (int_max_dist < 0 || dist <= int_max_dist)
   {
     if (eval_mode == EVALMODE_SV)
     {
-      int_max_dist = new_sol_dist;
+      int_max_dist = dist;
 
-      this->process_sol(int_dist2Float(int_max_dist), new_sol_coord, max_dist);
+      this->process_sol(int_dist2Float(int_max_dist), coord, max_dist);
     }
     else if (eval_mode == EVALMODE_PRINT)
     {
-      cout << new_sol_coord << "\n";
+      cout << coord << "\n";
     }
   }
 }
 
+void ExactErrorBoundedEvaluator::eval_sol(const FloatVect &new_sol_coord,
+                                          const enumf &new_partial_dist, enumf &max_dist)
+{
+  process_exact_sol(exact_sol_dist(new_sol_coord), new_sol_coord, max_dist);
+}
+
 void ExactErrorBoundedEvaluator::eval_sub_sol(int offset, const FloatVect &new_sub_sol_coord,
                                               const enumf &sub_dist)
 {
-  Integer minusone;
-  minusone = -1;
+  Float subdist = int_dist2Float(exact_subsol_dist(offset, new_sub_sol_coord));
 
-  int n = matrix.get_cols();
-  Integer new_sol_dist, coord;
-  IntVect new_sol;
+  sub_solutions.resize(std::max(sub_solutions.size(), std::size_t(offset + 1)));
+  if (sub_solutions[offset].second.empty() || subdist <= sub_solutions[offset].first)
+  {
+    sub_solutions[offset].first  = subdist;
+    sub_solutions[offset].second = new_sub_sol_coord;
+    for (int i                        = 0; i < offset; ++i)
+      sub_solutions[offset].second[i] = 0.0;
+  }
+}
 
-  gen_zero_vect(new_sol, n);
-  new_sol_dist = 0;
+void ExactErrorBoundedEvaluator::eval_raw_sol(const enumxt *new_sol_coord, int dim,
+                                              const enumf &new_partial_dist, enumf &max_dist)
+{
+  if (batch_size == 1)
+  {
+    Evaluator<Float>::eval_raw_sol(new_sol_coord, dim, new_partial_dist, max_dist);
+    return;
+  }
+  FPLLL_CHECK(dim == d, "ExactEvaluator: solution of another dimension");
+  if (batch_running && verified.load(std::memory_order_acquire))
+    finish_batch(max_dist);
+
+  /* Until the candidate is verified, the bound is lowered to new_partial_dist + 2 * maxDE, where
+     maxDE bounds the error on the norms of the vectors under the current bound: a vector shorter
+     than the candidate has a computed norm below it. */
+  if (eval_mode == EVALMODE_SV && max_sols == 1 && strategy == EVALSTRATEGY_BEST_N_SOLUTIONS)
+  {
+    if (batch_max_error < 0.0)
+    {
+      Float bound, max_de;
+      bound = max_dist;
+      bound.mul_2si(bound, normExp);
+      if (get_max_error_aux(bound, false, max_de))
+      {
+        max_de.mul_2si(max_de, 1);
+        batch_max_error = calc_enum_bound(max_de);
+      }
+      else
+        batch_max_error = numeric_limits<enumf>::infinity();
+    }
+    max_dist = min(max_dist, new_partial_dist + batch_max_error);
+  }
+  batch_coords.insert(batch_coords.end(), new_sol_coord, new_sol_coord + d);
+  if (batch_coords.size() >= batch_size * d)
+    verify_batch(max_dist, batch_async);
+}
 
-  // Computes the distance between x[[offset,d)] and zero
-  for (int i = offset; i < d; i++)
+/* Candidates left in the last batch, and batch still being verified, at the end of the
+   enumeration */
+void ExactErrorBoundedEvaluator::sync_solutions()
+{
+  // the enumeration is finished, its bound is not used anymore
+  enumf max_dist = 0.0;
+  if (batch_coords.empty())
+    finish_batch(max_dist);
+  else
+    verify_batch(max_dist, false);
+}
+
+/* Verifies the candidates of batch_coords, by the verifier thread if `async` is set. */
+void ExactErrorBoundedEvaluator::verify_batch(enumf &max_dist, bool async)
+{
+  finish_batch(max_dist);
+  verified_coords.swap(batch_coords);
+  batch_coords.clear();
+  if (async)
   {
-    coord.set_f(new_sub_sol_coord[i]);
-    for (int j = 0; j < n; j++)
-      new_sol[j].addmul(coord, matrix(i, j));
+    if (!verifier.joinable())
+      verifier = std::thread(&ExactErrorBoundedEvaluator::run_verifier, this);
+    {
+      std::lock_guard<std::mutex> lock(verifier_mutex);
+      verified        = false;
+      batch_submitted = true;
+    }
+    batch_running = true;
+    verifier_start.notify_one();
   }
-  for (int i = 0; i < n; i++)
+  else
   {
-    coord = new_sol[i];
-    new_sol_dist.addmul(coord, coord);
+    exact_batch_dists();
+    finish_batch(max_dist);
   }
-  Float subdist = int_dist2Float(new_sol_dist);
+}
 
-  sub_solutions.resize(std::max(sub_solutions.size(), std::size_t(offset + 1)));
-  if (sub_solutions[offset].second.empty() || subdist <= sub_solutions[offset].first)
+/* Waits for the batch being verified and processes its solutions in the order of the
+   enumeration. The bound lowered by eval_raw_sol() stays valid. */
+void ExactErrorBoundedEvaluator::finish_batch(enumf &max_dist)
+{
+  if (batch_running)
   {
-    sub_solutions[offset].first  = subdist;
-    sub_solutions[offset].second = new_sub_sol_coord;
-    for (int i                        = 0; i < offset; ++i)
-      sub_solutions[offset].second[i] = 0.0;
+    std::unique_lock<std::mutex> lock(verifier_mutex);
+    verifier_done.wait(lock, [this] { return !batch_submitted; });
+    batch_running = false;
+  }
+  enumf bound  = max_dist;
+  size_t count = verified_coords.size() / d;
+  FloatVect coord(d);
+  for (size_t c = 0; c < count; c++)
+  {
+    if (int_max_dist >= 0 && verified_dists[c] > int_max_dist)
+      continue;
+    for (int i = 0; i < d; i++)
+      coord[i] = verified_coords[c * d + i];
+    process_exact_sol(verified_dists[c], coord, max_dist);
+  }
+  max_dist = min(max_dist, bound);
+  verified_coords.clear();
+}
+
+/* Loop of the verifier thread: verifies the batches given by verify_batch() one at a time */
+void ExactErrorBoundedEvaluator::run_verifier()
+{
+  std::unique_lock<std::mutex> lock(verifier_mutex);
+  while (true)
+  {
+    verifier_start.wait(lock, [this] { return batch_submitted || verifier_stop; });
+    if (!batch_submitted)
+      return;
+    lock.unlock();
+    exact_batch_dists();
+    lock.lock();
+    batch_submitted = false;
+    verified.store(true, std::memory_order_release);
+    verifier_done.notify_one();
+  }
+}
+
+/* Exact squared norms of the candidates of verified_coords. All the candidates of the batch are
+   updated with a row of the basis before the next row is read. */
+void ExactErrorBoundedEvaluator::exact_batch_dists()
+{
+  int n        = matrix.get_cols();
+  size_t count = verified_coords.size() / d;
+  if (batch_vects.size() < count)
+    batch_vects.resize(count);
+  if (verified_dists.size() < count)
+    verified_dists.resize(count);
+
+  for (size_t c = 0; c < count; c++)
+  {
+    batch_vects[c].resize(n);
+    for (int j = 0; j < n; j++)
+      batch_vects[c][j] = 0;
+  }
+  for (int i = 0; i < d; i++)
+  {
+    for (size_t c = 0; c < count; c++)
+    {
+      long coord = static_cast<long>(verified_coords[c * d + i]);
+      if (coord == 0)
+        continue;
+      for (int j = 0; j < n; j++)
+        batch_vects[c][j].addmul_si(matrix(i, j), coord);
+    }
+  }
+  for (size_t c = 0; c < count; c++)
+  {
+    verified_dists[c] = 0;
+    for (int j = 0; j < n; j++)
+      verified_dists[c].addmul(batch_vects[c][j], batch_vects[c][j]);
   }
 }
 
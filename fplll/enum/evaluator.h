@@ -17,8 +17,13 @@
 #define FPLLL_EVALUATOR_H
 
 #include "../util.h"
+#include <atomic>
+#include <condition_variable>
+#include <limits>
 #include <map>
+#include <mutex>
 #include <queue>
+#include <thread>
 
 FPLLL_BEGIN_NAMESPACE
 
@@ -88,10 +93,49 @@ public:
   virtual void eval_sub_sol(int offset, const vector<FT> &new_sub_sol_coord,
                             const enumf &sub_dist) = 0;
 
+  /**
+   * Interface for the enumerator without conversion of the coordinates
+   * new_sol_coord[0], ..., new_sol_coord[dim - 1]. By default they are converted to FT and passed
+   * to eval_sol, evaluators which store their solutions in another form can override it.
+   */
+  virtual void eval_raw_sol(const enumxt *new_sol_coord, int dim, const enumf &new_partial_dist,
+                            enumf &max_dist)
+  {
+    raw_sol_coord.resize(dim);
+    for (int i = 0; i < dim; ++i)
+      raw_sol_coord[i] = new_sol_coord[i];
+    eval_sol(raw_sol_coord, new_partial_dist, max_dist);
+  }
+
+  /**
+   * Same as eval_raw_sol for the subsolution at `offset`: only new_sub_sol_coord[offset], ...,
+   * new_sub_sol_coord[dim - 1] are set. By default they are converted to FT, with zeros below
+   * offset, and passed to eval_sub_sol.
+   */
+  virtual void eval_raw_sub_sol(int offset, const enumxt *new_sub_sol_coord, int dim,
+                                const enumf &sub_dist)
+  {
+    raw_sol_coord.resize(dim);
+    for (int i = 0; i < offset; ++i)
+      raw_sol_coord[i] = 0.0;
+    for (int i = offset; i < dim; ++i)
+      raw_sol_coord[i] = new_sub_sol_coord[i];
+    eval_sub_sol(offset, raw_sol_coord, sub_dist);
+  }
+
   virtual void set_normexp(long norm_exp) { normExp = norm_exp; }
   long normExp;
 
+  /** true if eval_sol and eval_sub_sol may be called by several threads at once */
+  virtual bool is_thread_safe() const { return false; }
+
+  /** called by the enumeration when it is finished, before the solutions are read */
+  virtual void sync_solutions() {}
+
 protected:
+  /** coordinates converted by eval_raw_sol */
+  std::vector<FT> raw_sol_coord;
+
   /** calculate enumeration bound based on dist */
   virtual enumf calc_enum_bound(const FT &dist) const
   {
@@ -187,6 +231,431 @@ public:
   }
 };
 
+/**
+ * FastEvaluator which does not convert the solutions of an enumeration to FT as they are found.
+ * They are kept as enumxt coordinates in rows which are reused, and only the solutions which are
+ * still kept at the end are converted to FT (see sync_solutions()). Likewise, the best subsolution
+ * of each offset is overwritten in place in a table with one row per offset, and only these are
+ * converted to sub_solutions at the end. The solutions and subsolutions do not go through eval_sol
+ * and eval_sub_sol, hence evaluators which override them must derive from FastEvaluator instead.
+ */
+template <class FT> class PooledEvaluator : public FastEvaluator<FT>
+{
+public:
+  using Evaluator<FT>::max_sols;
+  using Evaluator<FT>::strategy;
+  using Evaluator<FT>::normExp;
+  using Evaluator<FT>::sub_solutions;
+
+  PooledEvaluator(size_t nr_solutions               = 1,
+                  EvaluatorStrategy update_strategy = EVALSTRATEGY_BEST_N_SOLUTIONS,
+                  bool find_subsolutions            = false)
+      : FastEvaluator<FT>(nr_solutions, update_strategy, find_subsolutions), sub_dim(0)
+  {
+  }
+  virtual ~PooledEvaluator() {}
+
+  /** same as eval_sol and process_sol, on the solutions of the current enumeration */
+  virtual void eval_raw_sol(const enumxt *new_sol_coord, int dim, const enumf &new_partial_dist,
+                            enumf &max_dist)
+  {
+    ++this->sol_count;
+    add_pending(new_sol_coord, dim, new_partial_dist);
+    switch (strategy)
+    {
+    case EVALSTRATEGY_BEST_N_SOLUTIONS:
+      if (pending.size() < max_sols)
+        return;
+      if (pending.size() > max_sols)
+        remove_longest_pending();
+      max_dist = pending.front().first;
+      break;
+
+    case EVALSTRATEGY_OPPORTUNISTIC_N_SOLUTIONS:
+      max_dist = new_partial_dist;
+      if (pending.size() <= max_sols)
+        return;
+      remove_longest_pending();
+      break;
+
+    case EVALSTRATEGY_FIRST_N_SOLUTIONS:
+      if (pending.size() < max_sols)
+        return;
+      max_dist = 0;
+      break;
+
+    default:
+      FPLLL_CHECK(false, "Evaluator: invalid strategy switch!");
+    }
+  }
+
+  /** same as eval_sub_sol, on the subsolutions of the current enumeration */
+  virtual void eval_raw_sub_sol(int offset, const enumxt *new_sub_sol_coord, int dim,
+                                const enumf &sub_dist)
+  {
+    if (dim != sub_dim)
+    {
+      sync_sub_solutions();
+      sub_dim = dim;
+      sub_dists.assign(dim, std::numeric_limits<enumf>::infinity());
+      sub_table.resize(dim * dim);
+    }
+    if (sub_dist >= sub_dists[offset])
+      return;
+    sub_dists[offset] = sub_dist;
+    std::copy(new_sub_sol_coord + offset, new_sub_sol_coord + dim,
+              sub_table.begin() + offset * dim + offset);
+  }
+
+  /* Called at the beginning of an enumeration: the solutions stored so far become pending
+     solutions, with lengths normalized by 2^norm_exp. */
+  virtual void set_normexp(long norm_exp)
+  {
+    sync_sub_solutions();
+    for (auto &sol : pending)
+      sol.first = ldexp(sol.first, normExp - norm_exp);
+    normExp = norm_exp;
+
+    FT dist;
+    for (auto it = this->solutions.begin(); it != this->solutions.end(); ++it)
+    {
+      dist.mul_2si(it->first, -normExp);
+      size_t row = free_row();
+      rows[row].resize(it->second.size());
+      for (size_t i = 0; i < it->second.size(); ++i)
+        rows[row][i] = it->second[i].get_d();
+      pending.emplace_back(dist.get_d(), row);
+      std::push_heap(pending.begin(), pending.end());
+    }
+    this->solutions.clear();
+  }
+
+  virtual void sync_solutions()
+  {
+    FT dist;
+    for (const auto &sol : pending)
+    {
+      dist = sol.first;
+      dist.mul_2si(dist, normExp);
+      const vector<enumxt> &row = rows[sol.second];
+      vector<FT> coord(row.size());
+      for (size_t i = 0; i < row.size(); ++i)
+        coord[i] = row[i];
+      this->solutions.emplace(dist, coord);
+      free_rows.push_back(sol.second);
+    }
+    pending.clear();
+    sync_sub_solutions();
+  }
+
+private:
+  /* coordinates of the pending solutions and rows which can be reused */
+  vector<vector<enumxt>> rows;
+  vector<size_t> free_rows;
+  /* normalized length and row of the pending solutions, in a heap with the longest first */
+  vector<std::pair<enumf, size_t>> pending;
+  /* subsolutions of the current enumeration: normalized length for each offset (infinity if there
+     is none) and coordinates offset, ..., sub_dim - 1 in row offset of a sub_dim x sub_dim table */
+  int sub_dim;
+  vector<enumf> sub_dists;
+  vector<enumxt> sub_table;
+
+  /* converts the subsolutions of the table which are shorter than those of sub_solutions */
+  void sync_sub_solutions()
+  {
+    FT dist;
+    for (int offset = 0; offset < sub_dim; ++offset)
+    {
+      if (sub_dists[offset] == std::numeric_limits<enumf>::infinity())
+        continue;
+      dist = sub_dists[offset];
+      dist.mul_2si(dist, normExp);
+      sub_dists[offset] = std::numeric_limits<enumf>::infinity();
+      sub_solutions.resize(std::max(sub_solutions.size(), std::size_t(offset + 1)));
+      auto &sub_sol = sub_solutions[offset];
+      if (!sub_sol.second.empty() && !(dist < sub_sol.first))
+        continue;
+      sub_sol.first = dist;
+      sub_sol.second.resize(sub_dim);
+      for (int i = 0; i < offset; ++i)
+        sub_sol.second[i] = 0.0;
+      for (int i = offset; i < sub_dim; ++i)
+        sub_sol.second[i] = sub_table[offset * sub_dim + i];
+    }
+  }
+
+  size_t free_row()
+  {
+    if (free_rows.empty())
+    {
+      rows.emplace_back();
+      return rows.size() - 1;
+    }
+    size_t row = free_rows.back();
+    free_rows.pop_back();
+    return row;
+  }
+
+  void add_pending(const enumxt *coord, int dim, enumf dist)
+  {
+    size_t row = free_row();
+    rows[row].assign(coord, coord + dim);
+    pending.emplace_back(dist, row);
+    std::push_heap(pending.begin(), pending.end());
+  }
+
+  void remove_longest_pending()
+  {
+    std::pop_heap(pending.begin(), pending.end());
+    free_rows.push_back(pending.back().second);
+    pending.pop_back();
+  }
+};
+
+/**
+ * Evaluator used by the worker threads of a parallel enumeration.
+ * It forwards every call to a shared evaluator while holding a lock, such that
+ * evaluators which are not thread-safe can be used by several threads at once.
+ * Solutions are only stored in the shared evaluator.
+ */
+template <class FT> class SynchronizedEvaluator : public Evaluator<FT>
+{
+public:
+  SynchronizedEvaluator(Evaluator<FT> &evaluator, std::mutex &mutex)
+      : Evaluator<FT>(evaluator.max_sols, evaluator.strategy, evaluator.findsubsols),
+        evaluator(evaluator), mutex(mutex)
+  {
+    this->normExp = evaluator.normExp;
+  }
+  virtual ~SynchronizedEvaluator() {}
+
+  virtual void eval_sol(const vector<FT> &new_sol_coord, const enumf &new_partial_dist,
+                        enumf &max_dist)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++this->sol_count;
+    evaluator.eval_sol(new_sol_coord, new_partial_dist, max_dist);
+  }
+
+  virtual void eval_sub_sol(int offset, const vector<FT> &new_sub_sol_coord, const enumf &sub_dist)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    evaluator.eval_sub_sol(offset, new_sub_sol_coord, sub_dist);
+  }
+
+  virtual void eval_raw_sub_sol(int offset, const enumxt *new_sub_sol_coord, int dim,
+                                const enumf &sub_dist)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    evaluator.eval_raw_sub_sol(offset, new_sub_sol_coord, dim, sub_dist);
+  }
+
+  virtual void eval_raw_sol(const enumxt *new_sol_coord, int dim, const enumf &new_partial_dist,
+                            enumf &max_dist)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++this->sol_count;
+    evaluator.eval_raw_sol(new_sol_coord, dim, new_partial_dist, max_dist);
+  }
+
+  /* the normalization exponent is set once by the master enumeration */
+  virtual void set_normexp(long norm_exp) { this->normExp = norm_exp; }
+
+private:
+  Evaluator<FT> &evaluator;
+  std::mutex &mutex;
+};
+
+/**
+ * Thread-safe evaluator for parallel enumerations (see Enumeration::set_threads()), which can be
+ * used instead of FastEvaluator there. The solutions are kept in a buffer of nr_solutions slots
+ * of dimension at most max_dim which is allocated once: a thread claims a slot by an atomic
+ * compare-and-swap on the length of the solution stored in it and the enumeration bound is an
+ * atomic shared by all threads. Threads only wait for each other when all slots are being written.
+ * The solutions are copied to the solutions container when the enumeration is finished.
+ * With EVALSTRATEGY_FIRST_N_SOLUTIONS, solutions found after the first nr_solutions are dropped.
+ * Subsolutions are not supported.
+ */
+template <class FT> class ConcurrentEvaluator : public Evaluator<FT>
+{
+public:
+  using Evaluator<FT>::max_sols;
+  using Evaluator<FT>::strategy;
+  using Evaluator<FT>::normExp;
+
+  ConcurrentEvaluator(size_t nr_solutions               = 1,
+                      EvaluatorStrategy update_strategy = EVALSTRATEGY_BEST_N_SOLUTIONS,
+                      int max_dim                       = FPLLL_MAX_ENUM_DIMENSION)
+      : Evaluator<FT>(nr_solutions, update_strategy, false), slots(nr_solutions), dim(max_dim),
+        stride((max_dim + 7) & ~7), coord_buffer(nr_solutions * stride + 7)
+  {
+    // rows of coordinates start on a cache line
+    size_t misalignment = reinterpret_cast<uintptr_t>(coord_buffer.data()) % 64;
+    coords              = coord_buffer.data() + (64 - misalignment) % 64 / sizeof(enumf);
+    for (Slot &slot : slots)
+    {
+      slot.dist = std::numeric_limits<enumf>::infinity();
+      slot.dim  = 0;
+    }
+    bound          = std::numeric_limits<enumf>::infinity();
+    stored         = 0;
+    solution_count = 0;
+    normExp        = 0;
+  }
+  virtual ~ConcurrentEvaluator() {}
+
+  virtual void eval_sol(const vector<FT> &new_sol_coord, const enumf &new_partial_dist,
+                        enumf &max_dist)
+  {
+    insert_sol(new_sol_coord.data(), new_sol_coord.size(), new_partial_dist, max_dist);
+  }
+
+  virtual void eval_raw_sol(const enumxt *new_sol_coord, int dim, const enumf &new_partial_dist,
+                            enumf &max_dist)
+  {
+    insert_sol(new_sol_coord, dim, new_partial_dist, max_dist);
+  }
+
+  virtual void eval_sub_sol(int, const vector<FT> &, const enumf &)
+  {
+    FPLLL_CHECK(false, "ConcurrentEvaluator: subsolutions are not supported");
+  }
+
+  /* the stored lengths and the bound are normalized by 2^normExp */
+  virtual void set_normexp(long norm_exp)
+  {
+    for (Slot &slot : slots)
+      slot.dist = ldexp(slot.dist.load(), normExp - norm_exp);
+    bound   = ldexp(bound.load(), normExp - norm_exp);
+    normExp = norm_exp;
+  }
+
+  virtual bool is_thread_safe() const { return true; }
+
+  virtual void sync_solutions()
+  {
+    FT dist;
+    this->solutions.clear();
+    for (size_t i = 0; i < max_sols; ++i)
+    {
+      if (slots[i].dist == std::numeric_limits<enumf>::infinity())
+        continue;
+      dist = slots[i].dist.load();
+      dist.mul_2si(dist, normExp);
+      vector<FT> coord(slots[i].dim);
+      for (int j = 0; j < slots[i].dim; ++j)
+        coord[j] = coords[i * stride + j];
+      this->solutions.emplace(dist, coord);
+    }
+    this->sol_count = solution_count;
+  }
+
+private:
+  /* a slot of the solution buffer, which fills a cache line */
+  struct alignas(MATRIX_ALIGNMENT) Slot
+  {
+    std::atomic<enumf> dist;  // infinity if empty, -1 while the solution is written
+    int dim;
+  };
+
+  vector<Slot, MatrixAllocator<Slot>> slots;
+  int dim, stride;
+  vector<enumf> coord_buffer;
+  enumf *coords;
+  std::atomic<enumf> bound;
+  std::atomic<size_t> stored;  // number of slots claimed with EVALSTRATEGY_FIRST_N_SOLUTIONS
+  std::atomic<size_t> solution_count;
+
+  static inline enumf coord_value(const FT &coord) { return coord.get_d(); }
+  static inline enumf coord_value(const enumxt &coord) { return coord; }
+
+  template <class T>
+  void insert_sol(const T *new_sol_coord, int n, const enumf &new_partial_dist, enumf &max_dist)
+  {
+    ++solution_count;
+    if (strategy == EVALSTRATEGY_OPPORTUNISTIC_N_SOLUTIONS)
+      lower_bound(new_partial_dist);
+
+    size_t i = claim_slot(new_partial_dist);
+    if (i < max_sols)
+    {
+      FPLLL_CHECK(n <= dim, "ConcurrentEvaluator: dimension is too high");
+      enumf *coord = coords + i * stride;
+      for (int j = 0; j < n; ++j)
+        coord[j] = coord_value(new_sol_coord[j]);
+      slots[i].dim = n;
+      slots[i].dist.store(new_partial_dist, std::memory_order_release);
+      if (strategy == EVALSTRATEGY_BEST_N_SOLUTIONS)
+        update_bound();
+    }
+    max_dist = min(max_dist, bound.load());
+  }
+
+  /* Returns the slot in which the solution of length dist is to be written, or max_sols if it is
+     not kept. The slot is marked as being written. */
+  size_t claim_slot(enumf dist)
+  {
+    if (strategy == EVALSTRATEGY_FIRST_N_SOLUTIONS)
+    {
+      size_t i = stored++;
+      if (i + 1 >= max_sols)
+        bound = 0.0;
+      if (i >= max_sols)
+        return max_sols;
+      slots[i].dist = -1.0;
+      return i;
+    }
+    while (true)
+    {
+      // replace the longest solution
+      size_t longest     = max_sols;
+      enumf longest_dist = -1.0;
+      for (size_t i = 0; i < max_sols; ++i)
+      {
+        enumf slot_dist = slots[i].dist.load(std::memory_order_relaxed);
+        if (slot_dist > longest_dist)
+        {
+          longest      = i;
+          longest_dist = slot_dist;
+        }
+      }
+      if (longest == max_sols)
+      {
+        // all slots are being written
+        std::this_thread::yield();
+        continue;
+      }
+      if (dist >= longest_dist)
+        return max_sols;
+      if (slots[longest].dist.compare_exchange_weak(longest_dist, -1.0, std::memory_order_acquire))
+        return longest;
+    }
+  }
+
+  /* Once all slots are filled, the bound is the length of the longest stored solution. If a slot
+     is being written, the thread writing it updates the bound. */
+  void update_bound()
+  {
+    enumf longest_dist = 0.0;
+    for (size_t i = 0; i < max_sols; ++i)
+    {
+      enumf slot_dist = slots[i].dist.load(std::memory_order_acquire);
+      if (slot_dist < 0.0 || slot_dist == std::numeric_limits<enumf>::infinity())
+        return;
+      longest_dist = max(longest_dist, slot_dist);
+    }
+    lower_bound(longest_dist);
+  }
+
+  void lower_bound(enumf new_bound)
+  {
+    enumf current = bound.load();
+    while (new_bound < current && !bound.compare_exchange_weak(current, new_bound))
+    {
+    }
+  }
+};
+
 /**
  * ErrorBoundEvaluator provides an extra interface to provide
  * information about the accuracy of solutions.
@@ -194,8 +663,9 @@ public:
 class ErrorBoundedEvaluator : public Evaluator<Float>
 {
 public:
-  ErrorBoundedEvaluator(int dim, const Matrix<Float> &mmu, const Matrix<Float> &mr,
-                        EvaluatorMode evalmode, size_t nr_solutions = 1,
+  ErrorBoundedEvaluator(int dim, const TriangularMatrix<Float> &mmu,
+                        const TriangularMatrix<Float> &mr, EvaluatorMode evalmode,
+                        size_t nr_solutions               = 1,
                         EvaluatorStrategy update_strategy = EVALSTRATEGY_BEST_N_SOLUTIONS,
                         bool find_subsolutions            = false)
       : Evaluator(nr_solutions, update_strategy, find_subsolutions), eval_mode(evalmode), d(dim),
@@ -210,8 +680,8 @@ public:
   /** Configuration */
   EvaluatorMode eval_mode;
   int d;
-  const Matrix<Float> &mu;
-  const Matrix<Float> &r;
+  const TriangularMatrix<Float> &mu;
+  const TriangularMatrix<Float> &r;
 
   /* To enable error estimation, the caller must set
   input_error_defined=true and fill max_dr_diag and max_dm_u */
@@ -241,8 +711,9 @@ public:
 class FastErrorBoundedEvaluator : public ErrorBoundedEvaluator
 {
 public:
-  FastErrorBoundedEvaluator(int d = 0, const Matrix<Float> &mu = Matrix<Float>(),
-                            const Matrix<Float> &r  = Matrix<Float>(),
+  FastErrorBoundedEvaluator(int d = 0,
+                            const TriangularMatrix<Float> &mu = TriangularMatrix<Float>(),
+                            const TriangularMatrix<Float> &r  = TriangularMatrix<Float>(),
                             EvaluatorMode eval_mode = EVALMODE_SV, size_t nr_solutions = 1,
                             EvaluatorStrategy update_strategy = EVALSTRATEGY_BEST_N_SOLUTIONS,
                             bool find_subsolutions            = false)
@@ -257,6 +728,10 @@ public:
   virtual void eval_sub_sol(int offset, const FloatVect &new_sub_sol_coord, const enumf &sub_dist);
 };
 
+/* Default number of candidate solutions verified together by ExactErrorBoundedEvaluator (see
+   ExactErrorBoundedEvaluator::set_batch()). */
+const int EXACT_EVAL_BATCH_SIZE = 64;
+
 /**
  * ExactEvaluator stores the best solution found by enumerate.
  * The result is guaranteed, but the the evaluation of new solutions is longer.
@@ -264,19 +739,49 @@ public:
 class ExactErrorBoundedEvaluator : public ErrorBoundedEvaluator
 {
 public:
-  ExactErrorBoundedEvaluator(int d, const IntMatrix &matrix, const Matrix<Float> &mu,
-                             const Matrix<Float> &r, EvaluatorMode eval_mode,
+  ExactErrorBoundedEvaluator(int d, const IntMatrix &matrix, const TriangularMatrix<Float> &mu,
+                             const TriangularMatrix<Float> &r, EvaluatorMode eval_mode,
                              size_t nr_solutions               = 1,
                              EvaluatorStrategy update_strategy = EVALSTRATEGY_BEST_N_SOLUTIONS,
                              bool find_subsolutions            = false)
       : ErrorBoundedEvaluator(d, mu, r, eval_mode, nr_solutions, update_strategy,
                               find_subsolutions),
-        matrix(matrix)
+        matrix(matrix), batch_size(1), batch_async(false), batch_max_error(-1.0),
+        batch_running(false), batch_submitted(false), verifier_stop(false), verified(false)
   {
     int_max_dist = -1;
   }
 
-  virtual ~ExactErrorBoundedEvaluator() {}
+  virtual ~ExactErrorBoundedEvaluator()
+  {
+    if (verifier.joinable())
+    {
+      {
+        std::lock_guard<std::mutex> lock(verifier_mutex);
+        verifier_stop = true;
+      }
+      verifier_start.notify_one();
+      verifier.join();
+    }
+  }
+
+  /**
+   * Verifies the candidate solutions in batches of `batch_size`: their exact norms are computed
+   * together, each row of the basis being read once per batch, with temporaries reused from one
+   * batch to the next. If `async` is set, each batch is verified by a verifier thread while the
+   * enumeration goes on, and its solutions are taken into account (lowering the enumeration bound)
+   * at the first candidate found once it is done. The verifier thread is started at the first
+   * batch and kept until the evaluator is destroyed. The last batch is verified by
+   * sync_solutions() at the end of the enumeration. The verifier thread only reads the basis, the
+   * floating-point data (see init_delta_def()) is used by the thread of the enumeration. A batch
+   * size of 1 (the default) verifies each candidate when it is found. It is set before the
+   * enumeration.
+   */
+  void set_batch(size_t size, bool async = false)
+  {
+    batch_size  = max(size, size_t(1));
+    batch_async = async;
+  }
 
   /**
    * Sets max_error to 0: the result is guaranteed.
@@ -288,6 +793,17 @@ public:
 
   virtual void eval_sub_sol(int offset, const FloatVect &new_sub_sol_coord, const enumf &sub_dist);
 
+  virtual void eval_raw_sol(const enumxt *new_sol_coord, int dim, const enumf &new_partial_dist,
+                            enumf &max_dist);
+
+  virtual void sync_solutions();
+
+  virtual void set_normexp(long norm_exp)
+  {
+    normExp         = norm_exp;
+    batch_max_error = -1.0;
+  }
+
   Integer int_max_dist;  // Exact norm of the last vector
 
   Integer exact_sol_dist(const FloatVect &sol_coord);
@@ -295,8 +811,34 @@ public:
 
 private:
   Float int_dist2Float(Integer int_dist);
+  void process_exact_sol(const Integer &dist, const FloatVect &coord, enumf &max_dist);
+
+  void verify_batch(enumf &max_dist, bool async);
+  void finish_batch(enumf &max_dist);
+  void exact_batch_dists();
+  void run_verifier();
 
   const IntMatrix &matrix;  // matrix of the lattice
+
+  /* temporaries of exact_subsol_dist() */
+  IntVect sol_vect;
+  Integer sol_coord_z;
+
+  /* batched verification, see set_batch() */
+  size_t batch_size;
+  bool batch_async;
+  vector<enumxt> batch_coords;     // candidates found since the last batch, d coordinates each
+  vector<enumxt> verified_coords;  // candidates of the batch being verified
+  vector<Integer> verified_dists;  // their exact squared norms, computed by exact_batch_dists()
+  vector<IntVect> batch_vects;     // temporaries of exact_batch_dists()
+  enumf batch_max_error;           // 2 * maxDE under the bound of the enumeration, -1 if unknown
+  bool batch_running;  // a batch was given to the verifier thread and is not finished yet
+  std::thread verifier;
+  std::mutex verifier_mutex;
+  std::condition_variable verifier_start, verifier_done;
+  bool batch_submitted;        // the verifier thread has a batch to verify
+  bool verifier_stop;          // the verifier thread exits once it has no batch to verify
+  std::atomic<bool> verified;  // set by the verifier thread once the batch is verified
 };
 
 FPLLL_END_NAMESPACE
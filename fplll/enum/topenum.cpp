@@ -17,8 +17,8 @@
 
 FPLLL_BEGIN_NAMESPACE
 
-Enumerator::Enumerator(int d, const Matrix<Float> &mu, const Matrix<Float> &r, double argMaxVolume,
-                       int min_level)
+Enumerator::Enumerator(int d, const TriangularMatrix<Float> &mu, const TriangularMatrix<Float> &r,
+                       double argMaxVolume, int min_level)
     : mu(mu), r(r), kmin(min_level), d(d)
 {
   max_volume = argMaxVolume > 0 ? argMaxVolume : ENUM_MAX_VOLUME;
@@ -26,13 +26,13 @@ const int ENUM_MIN_LEVEL     = 20;
 class Enumerator
 {
 public:
-  Enumerator(int d, const Matrix<Float> &mu, const Matrix<Float> &r,
+  Enumerator(int d, const TriangularMatrix<Float> &mu, const TriangularMatrix<Float> &r,
              double max_volume = ENUM_MAX_VOLUME, int min_level = ENUM_MIN_LEVEL);
   bool enum_next(const Float &max_sqr_length);
   inline const vector<enumxt> &get_sub_tree() { return sub_tree; }
 private:
-  const Matrix<Float> &mu;
-  const Matrix<Float> &r;
+  const TriangularMatrix<Float> &mu;
+  const TriangularMatrix<Float> &r;
   int k, kmin, kmax, d;
   FloatVect center, dist;
   FloatVect x, dx, ddx;
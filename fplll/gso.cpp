@@ -26,22 +26,52 @@ inline void MatGSO<ZT, FT>::invalidate_gso_row(int i, int new_valid_cols)
 {
   FPLLL_DEBUG_CHECK(i >= 0 && i < n_known_rows && new_valid_cols >= 0 && new_valid_cols <= i + 1);
   gso_valid_cols[i] = min(gso_valid_cols[i], new_valid_cols);
+  if (enable_double_shadow)
+    double_shadow_valid_cols[i] = min(double_shadow_valid_cols[i], new_valid_cols);
+}
+
+template <class ZT, class FT> void MatGSO<ZT, FT>::update_double_shadow(int first, int last)
+{
+  FPLLL_DEBUG_CHECK(enable_double_shadow && first >= 0 && last <= n_known_rows);
+  long expo;
+  for (int i = first; i < last; i++)
+  {
+    FPLLL_DEBUG_CHECK(gso_valid_cols[i] == i + 1);
+    for (int j = double_shadow_valid_cols[i]; j < i; j++)
+      double_shadow_mu[(size_t)j * alloc_dim + i] = get_mu(ftmp1, i, j).get_d();
+    if (double_shadow_valid_cols[i] <= i)
+    {
+      ftmp1 = get_r_exp(i, i, expo);
+      expo += ftmp1.exponent();
+      ftmp1.mul_2si(ftmp1, -ftmp1.exponent());
+      double_shadow_r[i]      = ftmp1.get_d();
+      double_shadow_r_expo[i] = expo;
+    }
+    double_shadow_valid_cols[i] = i + 1;
+  }
 }
 
 template <class ZT, class FT> void MatGSO<ZT, FT>::update_bf(int i)
+{
+  update_bf(i, tmp_col_expo);
+}
+
+template <class ZT, class FT> void MatGSO<ZT, FT>::update_bf(int i, vector<long> &col_expo)
 {
   int n = max(n_known_cols, init_row_size[i]);
   if (enable_row_expo)
   {
     long max_expo = LONG_MIN;
+    if (static_cast<int>(col_expo.size()) < n)
+      col_expo.resize(n);
     for (int j = 0; j < n; j++)
     {
-      b(i, j).get_f_exp(bf(i, j), tmp_col_expo[j]);
-      max_expo = max(max_expo, tmp_col_expo[j]);
+      b(i, j).get_f_exp(bf(i, j), col_expo[j]);
+      max_expo = max(max_expo, col_expo[j]);
     }
     for (int j = 0; j < n; j++)
     {
-      bf(i, j).mul_2si(bf(i, j), tmp_col_expo[j] - max_expo);
+      bf(i, j).mul_2si(bf(i, j), col_expo[j] - max_expo);
     }
     row_expo[i] = max_expo;
   }
@@ -60,12 +90,13 @@ template <class ZT, class FT> void MatGSO<ZT, FT>::invalidate_gram_row(int i)
     gf(i, j).set_nan();
 }
 
-template <class ZT, class FT> void MatGSO<ZT, FT>::row_op_end(int first, int last)
+template <class ZT, class FT> void MatGSO<ZT, FT>::row_op_end(int first, int last, int keep_cols)
 {
 #ifdef DEBUG
   FPLLL_DEBUG_CHECK(row_op_first == first && row_op_last == last);
   row_op_first = row_op_last = -1;
 #endif
+  stamp_rows(first, last);
   for (int i = first; i < last; i++)
   {
     if (!enable_int_gram)
@@ -75,7 +106,7 @@ template <class ZT, class FT> void MatGSO<ZT, FT>::row_op_end(int first, int las
       for (int j = i + 1; j < n_known_rows; j++)
         gf(j, i).set_nan();
     }
-    invalidate_gso_row(i, 0);
+    invalidate_gso_row(i, keep_cols);
   }
   for (int i = last; i < n_known_rows; i++)
   {
@@ -107,6 +138,8 @@ template <class ZT, class FT> void MatGSO<ZT, FT>::discover_row()
     invalidate_gram_row(i);
   }
   gso_valid_cols[i] = 0;
+  if (enable_double_shadow)
+    double_shadow_valid_cols[i] = 0;
 }
 
 template <class ZT, class FT> inline ZT MatGSO<ZT, FT>::get_max_gram()
@@ -157,6 +190,18 @@ template <class ZT, class FT> bool MatGSO<ZT, FT>::update_gso_row(int i, int las
   {
     discover_row();
   }
+  return update_gso_row(i, last_j, ftmp1, ftmp2);
+}
+
+template <class ZT, class FT>
+bool MatGSO<ZT, FT>::update_gso_row(int i, int last_j, RowTmp &tmp)
+{
+  return update_gso_row(i, last_j, tmp.ftmp1, tmp.ftmp2);
+}
+
+template <class ZT, class FT>
+bool MatGSO<ZT, FT>::update_gso_row(int i, int last_j, FT &ftmp1, FT &ftmp2)
+{
   FPLLL_DEBUG_CHECK(i >= 0 && i < n_known_rows && last_j >= 0 && last_j < n_source_rows);
 
   int j = max(0, gso_valid_cols[i]);
@@ -201,7 +246,12 @@ template <class ZT, class FT> void MatGSO<ZT, FT>::row_add(int i, int j)
     ztmp1.add(ztmp1, g(j, j));
     g(i, i).add(g(i, i), ztmp1);
 
-    for (int k = 0; k < n_known_rows; k++)
+    // g(i, k) += g(j, k) for k != i, on the contiguous parts of rows i and j first
+    int k_row = min(i, j);
+    MatrixRow<ZT> g_i = g[i], g_j = g[j];
+    for (int k = 0; k < k_row; k++)
+      g_i[k].add(g_i[k], g_j[k]);
+    for (int k = k_row; k < n_known_rows; k++)
       if (k != i)
         sym_g(i, k).add(sym_g(i, k), sym_g(j, k));
   }
@@ -224,7 +274,12 @@ template <class ZT, class FT> void MatGSO<ZT, FT>::row_sub(int i, int j)
     ztmp1.sub(g(j, j), ztmp1);
     g(i, i).add(g(i, i), ztmp1);
 
-    for (int k = 0; k < n_known_rows; k++)
+    // g(i, k) -= g(j, k) for k != i, on the contiguous parts of rows i and j first
+    int k_row = min(i, j);
+    MatrixRow<ZT> g_i = g[i], g_j = g[j];
+    for (int k = 0; k < k_row; k++)
+      g_i[k].sub(g_i[k], g_j[k]);
+    for (int k = k_row; k < n_known_rows; k++)
       if (k != i)
         sym_g(i, k).sub(sym_g(i, k), sym_g(j, k));
   }
@@ -251,13 +306,16 @@ template <class ZT, class FT> void MatGSO<ZT, FT>::row_addmul_si(int i, int j, l
     ztmp1.mul_si(ztmp1, x);
     g(i, i).add(g(i, i), ztmp1);
 
-    // g(i, k) += g(j, k) * (2^e * x) for k != i
-    for (int k = 0; k < n_known_rows; k++)
+    // g(i, k) += g(j, k) * x for k != i
+    int k_row = min(i, j);
+    MatrixRow<ZT> g_i = g[i], g_j = g[j];
+    for (int k = 0; k < k_row; k++)
+      g_i[k].addmul_si(g_j[k], x);
+    for (int k = k_row; k < n_known_rows; k++)
     {
       if (k == i)
         continue;
-      ztmp1.mul_si(sym_g(j, k), x);
-      sym_g(i, k).add(sym_g(i, k), ztmp1);
+      sym_g(i, k).addmul_si(sym_g(j, k), x);
     }
   }
 }
@@ -285,14 +343,19 @@ void MatGSO<ZT, FT>::row_addmul_si_2exp(int i, int j, long x, long expo)
     ztmp1.mul_2si(ztmp1, 2 * expo);
     g(i, i).add(g(i, i), ztmp1);
 
-    // g(i, k) += g(j, k) * (2^e * x) for k != i
-    for (int k = 0; k < n_known_rows; k++)
+    // g(i, k) += g(j, k) * (2^e * x) for k != i (e >= 0 from row_addmul_we)
+    FPLLL_DEBUG_CHECK(expo >= 0);
+    ztmp1 = x;
+    ztmp1.mul_2si(ztmp1, expo);
+    int k_row = min(i, j);
+    MatrixRow<ZT> g_i = g[i], g_j = g[j];
+    for (int k = 0; k < k_row; k++)
+      g_i[k].addmul(g_j[k], ztmp1);
+    for (int k = k_row; k < n_known_rows; k++)
     {
       if (k == i)
         continue;
-      ztmp1.mul_si(sym_g(j, k), x);
-      ztmp1.mul_2si(ztmp1, expo);
-      sym_g(i, k).add(sym_g(i, k), ztmp1);
+      sym_g(i, k).addmul(sym_g(j, k), ztmp1);
     }
   }
 }
@@ -324,14 +387,18 @@ void MatGSO<ZT, FT>::row_addmul_2exp(int i, int j, const ZT &x, long expo)
     ztmp1.mul_2si(ztmp1, 2 * expo);
     g(i, i).add(g(i, i), ztmp1);
 
-    // g(i, k) += g(j, k) * (2^e * x) for k != i
-    for (int k = 0; k < n_known_rows; k++)
+    // g(i, k) += g(j, k) * (2^e * x) for k != i (e >= 0 from row_addmul_we)
+    FPLLL_DEBUG_CHECK(expo >= 0);
+    ztmp1.mul_2si(x, expo);
+    int k_row = min(i, j);
+    MatrixRow<ZT> g_i = g[i], g_j = g[j];
+    for (int k = 0; k < k_row; k++)
+      g_i[k].addmul(g_j[k], ztmp1);
+    for (int k = k_row; k < n_known_rows; k++)
     {
       if (k == i)
         continue;
-      ztmp1.mul(sym_g(j, k), x);
-      ztmp1.mul_2si(ztmp1, expo);
-      sym_g(i, k).add(sym_g(i, k), ztmp1);
+      sym_g(i, k).addmul(sym_g(j, k), ztmp1);
     }
   }
 }
@@ -363,6 +430,44 @@ void MatGSO<ZT, FT>::row_addmul_we(int i, int j, const FT &x, long expo_add)
   }
 }
 
+template <class ZT, class FT>
+void MatGSO<ZT, FT>::row_addmul_we(int i, int j, const FT &x, long expo_add, RowTmp &tmp)
+{
+  FPLLL_DEBUG_CHECK(j >= 0 && i < n_known_rows && j < n_source_rows && !enable_int_gram &&
+                    !enable_inverse_transform);
+  long expo;
+  long lx = x.get_si_exp_we(expo, expo_add);
+
+  if (expo == 0)
+  {
+    if (lx == 0)
+      return;
+    b[i].addmul_si(b[j], lx, n_known_cols);
+    if (enable_transform)
+      u[i].addmul_si(u[j], lx);
+  }
+  else if (row_op_force_long)
+  {
+    b[i].addmul_si_2exp(b[j], lx, expo, n_known_cols, tmp.ztmp1);
+    if (enable_transform)
+      u[i].addmul_si_2exp(u[j], lx, expo, tmp.ztmp1);
+  }
+  else
+  {
+    x.get_z_exp_we(tmp.ztmp2, expo, expo_add);
+    b[i].addmul_2exp(b[j], tmp.ztmp2, expo, n_known_cols, tmp.ztmp1);
+    if (enable_transform)
+      u[i].addmul_2exp(u[j], tmp.ztmp2, expo, tmp.ztmp1);
+  }
+}
+
+template <class ZT, class FT> void MatGSO<ZT, FT>::row_op_end(int i, RowTmp &tmp)
+{
+  update_bf(i, tmp.col_expo);
+  invalidate_gram_row(i);
+  invalidate_gso_row(i, 0);
+}
+
 template <class ZT, class FT> void MatGSO<ZT, FT>::row_swap(int i, int j)
 {
   FPLLL_DEBUG_CHECK(!enable_inverse_transform);
@@ -387,6 +492,13 @@ template <class ZT, class FT> void MatGSO<ZT, FT>::row_swap(int i, int j)
 template <class ZT, class FT> void MatGSO<ZT, FT>::move_row(int old_r, int new_r)
 {
   FPLLL_DEBUG_CHECK(!cols_locked);
+  stamp_rows(min(old_r, new_r), max(old_r, new_r) + 1);
+  if (enable_double_shadow)
+  {
+    // the shadow is not moved with the rows
+    for (int i = min(old_r, new_r); i <= max(old_r, new_r) && i < n_known_rows; i++)
+      double_shadow_valid_cols[i] = 0;
+  }
   if (new_r < old_r)
   {
     FPLLL_DEBUG_CHECK(old_r < n_known_rows && !cols_locked);
@@ -496,20 +608,29 @@ template <class ZT, class FT> void MatGSO<ZT, FT>::size_increased()
   if (d > alloc_dim)
   {
     if (enable_int_gram)
-      g.resize(d, d);
+      g.resize(d);
     else
     {
       bf.resize(d, b.get_cols());
-      gf.resize(d, d);
+      gf.resize(d);
     }
-    mu.resize(d, d);
-    r.resize(d, d);
+    mu.resize(d);
+    r.resize(d);
     gso_valid_cols.resize(d);
+    row_op_stamps.resize(d);
     init_row_size.resize(d);
     if (enable_row_expo)
     {
       row_expo.resize(d);
     }
+    if (enable_double_shadow)
+    {
+      // the layout of the shadow depends on alloc_dim, it is converted again
+      double_shadow_mu.resize((size_t)d * d);
+      double_shadow_r.resize(d);
+      double_shadow_r_expo.resize(d);
+      double_shadow_valid_cols.assign(d, 0);
+    }
     alloc_dim = d;
   }
 
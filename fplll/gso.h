@@ -27,7 +27,8 @@ enum MatGSOFlags
   GSO_DEFAULT       = 0,
   GSO_INT_GRAM      = 1,
   GSO_ROW_EXPO      = 2,
-  GSO_OP_FORCE_LONG = 4
+  GSO_OP_FORCE_LONG = 4,
+  GSO_DOUBLE_SHADOW = 8
 };
 
 /**
@@ -88,13 +89,18 @@ public:
    * @param row_op_force_long
    *   Affects the behaviour of row_addmul(_we).
    *   See the documentation of row_addmul.
+   * @param enable_double_shadow
+   *   If true, a copy of mu and r in double is kept for the enumeration.
+   *   See the documentation of update_double_shadow.
    */
   //~ MatGSO(Matrix<ZT>& b, Matrix<ZT>& u, Matrix<ZT>& u_inv_t, int flags);
   MatGSO(Matrix<ZT> &arg_b, Matrix<ZT> &arg_u, Matrix<ZT> &arg_uinv_t, int flags)
       : b(arg_b), enable_int_gram(flags & GSO_INT_GRAM), enable_row_expo(flags & GSO_ROW_EXPO),
         enable_transform(arg_u.get_rows() > 0), enable_inverse_transform(arg_uinv_t.get_rows() > 0),
-        row_op_force_long(flags & GSO_OP_FORCE_LONG), u(arg_u), u_inv_t(arg_uinv_t),
-        n_known_rows(0), n_source_rows(0), n_known_cols(0), cols_locked(false), alloc_dim(0)
+        row_op_force_long(flags & GSO_OP_FORCE_LONG),
+        enable_double_shadow(flags & GSO_DOUBLE_SHADOW), u(arg_u), u_inv_t(arg_uinv_t),
+        n_known_rows(0), n_source_rows(0), n_known_cols(0), cols_locked(false), alloc_dim(0),
+        n_row_ops(0)
   {
     FPLLL_DEBUG_CHECK(!(enable_int_gram && enable_row_expo));
     d = b.get_rows();
@@ -132,9 +138,20 @@ public:
 
   /**
    * Must be called after a sequence of row_addmul(_we). This invalidates the
-   * i-th line of the GSO.
+   * i-th line of the GSO, except its coefficients of index < keep_cols when these
+   * have been recomputed after the operations (see the thread-safe row_addmul_we).
    */
-  void row_op_end(int first, int last);
+  void row_op_end(int first, int last, int keep_cols = 0);
+
+  /**
+   * Returns a number which changes whenever the rows first, ..., last - 1 of b may have been
+   * modified (see row_op_end) or moved (see move_row and create_rows), and with them their GSO.
+   * Operations on other rows leave it unchanged: they keep the span of the preceding rows as long
+   * as the row_addmul(_we) between row_op_begin(first, last) and row_op_end(first, last) only add
+   * rows of index < last, as done in fplll. Data computed from the GSO of a block, like the dual
+   * GSO cached by EnumerationDyn, can thus be reused until the stamp of the block changes.
+   */
+  inline long get_row_op_stamp(int first, int last) const;
 
   /**
    * Returns Gram matrix coefficients (0 &lt;= i &lt; n_known_rows and
@@ -152,22 +169,24 @@ public:
    * Coefficients of the Gram Schmidt Orthogonalization
    * (lower triangular matrix)
    * mu(i, j) = r(i, j) / ||b*_j||^2.
+   * Only the elements (i, j) with j <= i are stored, see TriangularMatrix::to_matrix() to get a
+   * square copy.
    */
-  const Matrix<FT> &get_mu_matrix() { return mu; }
+  const TriangularMatrix<FT> &get_mu_matrix() const { return mu; }
 
   /**
    * Returns the r matrix
    * Coefficients of the Gram Schmidt Orthogonalization
    * (lower triangular matrix)
    */
-  const Matrix<FT> &get_r_matrix() { return r; }
+  const TriangularMatrix<FT> &get_r_matrix() const { return r; }
 
   /**
    * Returns the g matrix (Z_NR version of r)
    * Coefficients of the Gram Schmidt Orthogonalization
    * (lower triangular matrix)
    */
-  const Matrix<ZT> &get_g_matrix() { return g; }
+  const TriangularMatrix<ZT> &get_g_matrix() const { return g; }
 
   /**
    * Returns f = mu(i, j) and expo such that
@@ -188,6 +207,26 @@ public:
    */
   inline FT &get_mu(FT &f, int i, int j);
 
+  /**
+   * Converts to double the coefficients of the rows first, ..., last - 1 of mu and r which have
+   * changed since their last conversion (enable_double_shadow must be true). Then
+   * get_double_shadow_mu(j)[i] = mu(i, j) and r(i, i) = get_double_shadow_r(i, expo) * 2^expo
+   * with 1/2 <= get_double_shadow_r(i, expo) < 1, for 0 <= j < i and first <= i < last, with the
+   * row exponents applied. The GSO of these rows must be valid.
+   * The columns of mu are stored contiguously, so that a block of rows of the enumeration is
+   * copied with memcpy.
+   */
+  void update_double_shadow(int first, int last);
+  inline const double *get_double_shadow_mu(int j) const
+  {
+    return &double_shadow_mu[(size_t)j * alloc_dim];
+  }
+  inline double get_double_shadow_r(int i, long &expo) const
+  {
+    expo = double_shadow_r_expo[i];
+    return double_shadow_r[i];
+  }
+
   /**
    * Return maximum bstar_i for all i
    */
@@ -238,6 +277,24 @@ public:
    */
   inline bool update_gso_row(int i);
 
+  /**
+   * Scratch variables of a thread calling the thread-safe update_gso_row, row_addmul_we and
+   * row_op_end below.
+   */
+  struct RowTmp
+  {
+    FT ftmp1, ftmp2;
+    ZT ztmp1, ztmp2;
+    vector<long> col_expo;
+  };
+
+  /**
+   * Thread-safe variant of update_gso_row(i, last_j) for a known row i (see discover_rows).
+   * Several threads can update distinct rows as long as the rows of index <= last_j are not
+   * modified meanwhile.
+   */
+  bool update_gso_row(int i, int last_j, RowTmp &tmp);
+
   /**
    * Updates all GSO coefficients (mu and r).
    */
@@ -248,6 +305,11 @@ public:
    */
   inline void discover_all_rows();
 
+  /**
+   * Allows row_addmul(_we) for the rows of index < last even if their GSO has never been computed.
+   */
+  inline void discover_rows(int last);
+
   /**
    * Sets the value of r(i, j). During the execution of LLL, some coefficients
    * are computed by the algorithm. They are set directly to avoid double
@@ -283,6 +345,23 @@ public:
    */
   void row_addmul_we(int i, int j, const FT &x, long expo_add);
 
+  /**
+   * Thread-safe variant of row_addmul_we, used by the parallel size reduction: several threads
+   * can add to distinct rows i multiples of rows j which are not modified meanwhile. Once done
+   * with row i, a thread calls row_op_end(i, tmp) before update_gso_row(i, last_j, tmp). When
+   * all threads are done with the rows first, ..., last - 1, the operations are recorded by
+   * row_op_begin(first, last) and row_op_end(first, last, keep_cols), where the GSO of these
+   * rows has been recomputed up to column keep_cols - 1.
+   * Requires enable_int_gram=false and enable_inverse_transform=false.
+   */
+  void row_addmul_we(int i, int j, const FT &x, long expo_add, RowTmp &tmp);
+
+  /**
+   * Updates the floating-point copy of b[i] and invalidates its Gram and GSO coefficients
+   * after the thread-safe row_addmul_we.
+   */
+  void row_op_end(int i, RowTmp &tmp);
+
   // b[i] += b[j] / b[i] -= b[j] (i > j)
   void row_add(int i, int j);
   void row_sub(int i, int j);
@@ -412,6 +491,9 @@ public:
    */
   const bool row_op_force_long;
 
+  /** Copy of mu and r in double (see update_double_shadow). */
+  const bool enable_double_shadow;
+
 private:
   /* Allocates matrices and arrays whose size depends on d (all but tmp_col_expo).
      When enable_int_gram=false, initializes bf. */
@@ -424,6 +506,9 @@ private:
   /* Upates the i-th row of bf. It does not invalidate anything, so the caller
      must take into account that it might change row_expo. */
   void update_bf(int i);
+  void update_bf(int i, vector<long> &col_expo);
+
+  bool update_gso_row(int i, int last_j, FT &ftmp1, FT &ftmp2);
   /* Marks g(i, j) for all j <= i (but NOT for j > i) */
   void invalidate_gram_row(int i);
 
@@ -437,6 +522,9 @@ private:
 
   inline ZT &sym_g(int i, int j) { return (i >= j) ? g(i, j) : g(j, i); }
 
+  // Marks the rows first, ..., last - 1 as modified by a new row operation (see get_row_op_stamp)
+  inline void stamp_rows(int first, int last);
+
   /* Floating-point representation of the basis. It is used when
      enable_int_gram=true. */
   Matrix<FT> bf;
@@ -466,7 +554,7 @@ private:
    * mu(i, j) is valid if 0 &lt;= i &lt; n_known_rows (&lt;= d) and
    * 0 &lt;= j &lt; min(gso_valid_cols[i], i)
    */
-  Matrix<FT> mu;
+  TriangularMatrix<FT> mu;
 
   /**
    * Coefficients of the Gram-Schmidt orthogonalization
@@ -480,17 +568,28 @@ private:
    * r(i, j) is valid if 0 &lt;= i &lt; n_known_rows (&lt;= d) and
    * 0 &lt;= j &lt; gso_valid_cols[i] (&lt;= i + 1).
    */
-  Matrix<FT> r;
+  TriangularMatrix<FT> r;
 
   /* Gram matrix (dot products of basis vectors, lower triangular matrix)
      g(i, j) is valid if 0 <= i < n_known_rows and j <= i */
-  Matrix<ZT> g;
-  Matrix<FT> gf;
+  TriangularMatrix<ZT> g;
+  TriangularMatrix<FT> gf;
 
   /* Number of valid columns of the i-th row of mu and r.
      Valid only for 0 <= i < n_known_rows */
   vector<int> gso_valid_cols;
 
+  /* Double shadow of mu (by columns) and r, see update_double_shadow. The row i is up to date in
+     the columns < double_shadow_valid_cols[i] (r(i, i) included if it is i + 1) */
+  vector<double> double_shadow_mu, double_shadow_r;
+  vector<long> double_shadow_r_expo;
+  vector<int> double_shadow_valid_cols;
+
+  /* row_op_stamps[i] is the number of the last row operation which modified or moved b[i],
+     n_row_ops the number of row operations so far (see get_row_op_stamp) */
+  vector<long> row_op_stamps;
+  long n_row_ops;
+
   /* Used by update_gso_row (+ update_gso), get_max_mu_exp and row_addmul_we. */
   FT ftmp1, ftmp2;
   /* Used by row_add, row_sub, row_addmul_si_2exp, row_addmul_2exp and
@@ -581,6 +680,23 @@ template <class ZT, class FT> inline FT &MatGSO<ZT, FT>::get_r(FT &f, int i, int
   return f;
 }
 
+template <class ZT, class FT>
+inline long MatGSO<ZT, FT>::get_row_op_stamp(int first, int last) const
+{
+  FPLLL_DEBUG_CHECK(first >= 0 && first <= last && last <= d);
+  long stamp = 0;
+  for (int i = first; i < last; i++)
+    stamp = max(stamp, row_op_stamps[i]);
+  return stamp;
+}
+
+template <class ZT, class FT> inline void MatGSO<ZT, FT>::stamp_rows(int first, int last)
+{
+  n_row_ops++;
+  for (int i = first; i < last; i++)
+    row_op_stamps[i] = n_row_ops;
+}
+
 template <class ZT, class FT> inline bool MatGSO<ZT, FT>::update_gso_row(int i)
 {
   return update_gso_row(i, i);
@@ -593,6 +709,8 @@ template <class ZT, class FT> inline void MatGSO<ZT, FT>::set_r(int i, int j, FT
   r(i, j) = f;
   if (gso_valid_cols[i] == j)
     gso_valid_cols[i]++;
+  if (enable_double_shadow)
+    double_shadow_valid_cols[i] = min(double_shadow_valid_cols[i], j);
 }
 
 template <class ZT, class FT> inline void MatGSO<ZT, FT>::row_addmul(int i, int j, const FT &x)
@@ -625,6 +743,7 @@ template <class ZT, class FT> inline void MatGSO<ZT, FT>::create_rows(int n_new_
         u[i][j]  = 0;
   }
   size_increased();
+  stamp_rows(old_d, d);
   if (n_known_rows == old_d)
     discover_all_rows();
 }
@@ -642,7 +761,13 @@ template <class ZT, class FT> inline void MatGSO<ZT, FT>::remove_last_rows(int n
 
 template <class ZT, class FT> inline void MatGSO<ZT, FT>::discover_all_rows()
 {
-  while (n_known_rows < d)
+  discover_rows(d);
+}
+
+template <class ZT, class FT> inline void MatGSO<ZT, FT>::discover_rows(int last)
+{
+  FPLLL_DEBUG_CHECK(last <= d);
+  while (n_known_rows < last)
     discover_row();
 }
 
@@ -19,6 +19,10 @@
 
 #include "lll.h"
 #include "util.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
 
 FPLLL_BEGIN_NAMESPACE
 
@@ -26,7 +30,7 @@ static inline bool is_power_of_2(int i) { return (i & (i - 1)) == 0; }
 
 template <class ZT, class FT>
 LLLReduction<ZT, FT>::LLLReduction(MatGSO<ZT, FT> &m, double delta, double eta, int flags)
-    : status(RED_SUCCESS), final_kappa(0), last_early_red(0), n_swaps(0), m(m)
+    : status(RED_SUCCESS), final_kappa(0), last_early_red(0), n_swaps(0), m(m), _threads(1)
 {
   /* No early reduction in proved mode (i.e. enable_int_gram=true).
      NOTE: To make this possible, the hypothesis "g(i, j) is valid if
@@ -220,6 +224,160 @@ bool LLLReduction<ZT, FT>::babai(int kappa, int size_reduction_end, int size_red
   return true;
 }
 
+template <class ZT, class FT> bool LLLReduction<ZT, FT>::parallel_size_reduction_supported() const
+{
+#ifdef FPLLL_WITH_LONG_DOUBLE
+  if (std::is_same<FT, FP_NR<long double>>::value)
+    return false;
+#endif
+  return std::is_same<ZT, Z_NR<mpz_t>>::value && !m.enable_int_gram &&
+         !m.enable_inverse_transform;
+}
+
+template <class ZT, class FT>
+bool LLLReduction<ZT, FT>::size_reduction_parallel(int kappa_min, int kappa_end,
+                                                   int size_reduction_start)
+{
+  int block_size         = max<int>(SIZE_RED_PARALLEL_ROWS, _threads);
+  unsigned int precision = FT::get_prec();
+  vector<SizeRedTmp> tmp(_threads);
+  for (unsigned int t = 0; t < _threads; t++)
+  {
+    extend_vect(tmp[t].babai_mu, kappa_end);
+    extend_vect(tmp[t].babai_expo, kappa_end);
+  }
+  m.discover_rows(kappa_end);
+
+  /* The threads are started once: the calling thread publishes each block [first, last) by
+     incrementing `round`, reduces its share of the rows and waits until `pending` threads are
+     done. */
+  std::mutex mutex;
+  std::condition_variable start, finish;
+  int first = kappa_min, last = kappa_min;
+  unsigned int round = 0, pending = 0;
+  bool done = false;
+  vector<int> statuses(_threads, RED_SUCCESS);
+  auto reduce_rows = [&](unsigned int t) {
+    for (int k = first + t; k < last && statuses[t] == RED_SUCCESS; k += _threads)
+      statuses[t] = babai_parallel(k, first, size_reduction_start, tmp[t]);
+  };
+  auto run_thread = [&](unsigned int t) {
+    FT::set_prec(precision);
+    for (unsigned int seen = 0;; seen++)
+    {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        start.wait(lock, [&] { return done || round != seen; });
+        if (done)
+          return;
+      }
+      reduce_rows(t);
+      std::lock_guard<std::mutex> lock(mutex);
+      if (--pending == 0)
+        finish.notify_one();
+    }
+  };
+  vector<std::thread> threads;
+  for (unsigned int t = 1; t < _threads; t++)
+    threads.emplace_back(run_thread, t);
+
+  // the serial part fails as size_reduction(), with the status set by babai() only
+  int new_status = RED_SUCCESS;
+  bool failed    = false;
+  for (; first < kappa_end && new_status == RED_SUCCESS && !failed; first = last)
+  {
+    if (first > size_reduction_start)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        last = min(first + block_size, kappa_end);
+        fill(statuses.begin(), statuses.end(), RED_SUCCESS);
+        pending = _threads - 1;
+        round++;
+      }
+      start.notify_all();
+      reduce_rows(0);
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        finish.wait(lock, [&] { return pending == 0; });
+      }
+      // the rows of the block kept their GSO coefficients of index < first up to date
+      m.row_op_begin(first, last);
+      m.row_op_end(first, last, first);
+      for (unsigned int t = 0; t < _threads && new_status == RED_SUCCESS; t++)
+        new_status = statuses[t];
+      if (new_status != RED_SUCCESS)
+        break;
+    }
+    else
+    {
+      last = min(first + block_size, kappa_end);
+    }
+    for (int k = first; k < last && !failed; k++)
+      failed = (k > 0 && !babai(k, k, size_reduction_start)) || !m.update_gso_row(k);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    done = true;
+  }
+  start.notify_all();
+  for (auto &thread : threads)
+    thread.join();
+  return !failed && set_status(new_status);
+}
+
+template <class ZT, class FT>
+int LLLReduction<ZT, FT>::babai_parallel(int kappa, int size_reduction_end,
+                                         int size_reduction_start, SizeRedTmp &tmp)
+{
+  long max_expo = LONG_MAX;
+
+  for (int iter = 0;; iter++)
+  {
+    if (!m.update_gso_row(kappa, size_reduction_end - 1, tmp.row_tmp))
+      return RED_GSO_FAILURE;
+
+    bool loop_needed = false;
+    for (int j = size_reduction_end - 1; j >= size_reduction_start && !loop_needed; j--)
+    {
+      m.get_mu(tmp.ftmp1, kappa, j);
+      tmp.ftmp1.abs(tmp.ftmp1);
+      loop_needed |= (tmp.ftmp1 > eta);
+    }
+    if (!loop_needed)
+      break;
+
+    if (iter >= 2)
+    {
+      long new_max_expo = m.get_max_mu_exp(kappa, size_reduction_end);
+      if (new_max_expo > max_expo - SIZE_RED_FAILURE_THRESH)
+        return RED_BABAI_FAILURE;
+      max_expo = new_max_expo;
+    }
+
+    for (int j = size_reduction_start; j < size_reduction_end; j++)
+    {
+      tmp.babai_mu[j] = m.get_mu_exp(kappa, j, tmp.babai_expo[j]);
+    }
+    for (int j = size_reduction_end - 1; j >= size_reduction_start; j--)
+    {
+      tmp.mu_m_ant.rnd_we(tmp.babai_mu[j], tmp.babai_expo[j]);
+      if (tmp.mu_m_ant.zero_p())
+        continue;
+      for (int k = size_reduction_start; k < j; k++)
+      {
+        tmp.ftmp1.mul(tmp.mu_m_ant, m.get_mu_exp(j, k));
+        tmp.babai_mu[k].sub(tmp.babai_mu[k], tmp.ftmp1);
+      }
+      tmp.mu_m_ant.neg(tmp.mu_m_ant);
+      m.row_addmul_we(kappa, j, tmp.mu_m_ant, tmp.babai_expo[j], tmp.row_tmp);
+    }
+    m.row_op_end(kappa, tmp.row_tmp);
+  }
+  return RED_SUCCESS;
+}
+
 template <class ZT, class FT> bool is_lll_reduced(MatGSO<ZT, FT> &m, double delta, double eta)
 {
   FT ftmp1;
@@ -66,6 +66,19 @@ public:
 
   inline bool size_reduction(int kappa_min = 0, int kappa_end = -1, int size_reduction_start = 0);
 
+  /**
+     @brief Number of threads used by size_reduction.
+
+     With several threads, size_reduction processes the rows by blocks of SIZE_RED_PARALLEL_ROWS
+     (or more) rows. The rows of a block are first reduced concurrently against the rows before the
+     block, which do not change meanwhile, then one after the other as with a single thread, which
+     then mostly adds small multiples of rows. This pays off when the row operations dominate, i.e.
+     with large mpz entries. It is only done with ZT=mpz_t, FT other than long double (whose
+     conversions are not thread-safe), enable_int_gram=false and enable_inverse_transform=false.
+  */
+  void set_threads(unsigned int threads) { _threads = max(threads, 1u); }
+  inline unsigned int get_threads() const { return _threads; }
+
   int status;
   int final_kappa;
   int last_early_red;
@@ -83,6 +96,22 @@ private:
   */
 
   bool babai(int kappa, int size_reduction_end, int size_reduction_start = 0);
+
+  /* Scratch variables of a thread of size_reduction_parallel */
+  struct SizeRedTmp
+  {
+    vector<FT> babai_mu;
+    vector<long> babai_expo;
+    FT mu_m_ant, ftmp1;
+    typename MatGSO<ZT, FT>::RowTmp row_tmp;
+  };
+
+  bool parallel_size_reduction_supported() const;
+  bool size_reduction_parallel(int kappa_min, int kappa_end, int size_reduction_start);
+  /* Same as babai(kappa, size_reduction_end, size_reduction_start), but can run concurrently on
+     distinct rows >= size_reduction_end. Returns the status instead of setting it. */
+  int babai_parallel(int kappa, int size_reduction_end, int size_reduction_start,
+                     SizeRedTmp &tmp);
   inline bool early_reduction(int start, int size_reduction_start = 0);
   inline void print_params();
   inline bool set_status(int new_status);
@@ -93,6 +122,7 @@ private:
   bool enable_early_red;
   bool siegel;
   bool verbose;
+  unsigned int _threads;
 
   vector<FT> lovasz_tests;
   vector<FT> babai_mu;
@@ -109,6 +139,11 @@ inline bool LLLReduction<ZT, FT>::size_reduction(int kappa_min, int kappa_end,
 {
   if (kappa_end == -1)
     kappa_end = m.d;
+  extend_vect(babai_mu, kappa_end);
+  extend_vect(babai_expo, kappa_end);
+  if (_threads > 1 && kappa_end - kappa_min > SIZE_RED_PARALLEL_ROWS &&
+      parallel_size_reduction_supported())
+    return size_reduction_parallel(kappa_min, kappa_end, size_reduction_start);
   for (int k = kappa_min; k < kappa_end; k++)
   {
     if ((k > 0 && !babai(k, k, size_reduction_start)) || !m.update_gso_row(k))
@@ -222,7 +222,10 @@ template <> int svpcvp(Options &o, ZZ_mat<mpz_t> &b, const vector<Z_NR<mpz_t>> &
     }
   }
 
-  if (target.empty())
+  if (target.empty() && !o.checkpoint_file.empty())
+    status = shortest_vector(b, sol_coord, o.checkpoint_file, SVPM_PROVED,
+                             flags | (o.resume ? SVP_RESUME : 0));
+  else if (target.empty())
     status = shortest_vector(b, sol_coord, SVPM_PROVED, flags);
   else
     status = closest_vector(b, target, sol_coord, flags);
@@ -379,6 +382,12 @@ void read_options(int argc, char **argv, Options &o)
       o.bkz_dump_gso_filename = argv[ac];
       o.bkz_flags |= BKZ_DUMP_GSO;
     }
+    else if (strcmp(argv[ac], "-checkpoint") == 0)
+    {
+      ++ac;
+      CHECK(ac < argc, "missing value after -checkpoint switch");
+      o.checkpoint_file = argv[ac];
+    }
     else if (strcmp(argv[ac], "-c") == 0)
     {
       ++ac;
@@ -423,6 +432,10 @@ void read_options(int argc, char **argv, Options &o)
       else
         ABORT_MSG("parse error in -f switch : mpfr, qd, dd, dpe or double expected");
     }
+    else if (strcmp(argv[ac], "-resume") == 0 || strcmp(argv[ac], "--resume") == 0)
+    {
+      o.resume = true;
+    }
     else if (strcmp(argv[ac], "-s") == 0)
     {
       ++ac;
@@ -530,6 +543,10 @@ void read_options(int argc, char **argv, Options &o)
            << "       Enable early reduction\n"
            << "  -b <block_size>\n"
            << "       Size of BKZ blocks\n"
+           << "  -checkpoint <filename>\n"
+           << "       Save the state of the SVP enumeration to filename regularly\n"
+           << "  -resume\n"
+           << "       Continue the SVP enumeration saved with -checkpoint\n"
            << "  -v\n"
            << "       Enable verbose mode\n";
       exit(0);
@@ -556,6 +573,7 @@ void read_options(int argc, char **argv, Options &o)
       o.input_file = argv[ac];
     }
   }
+  CHECK(!o.resume || !o.checkpoint_file.empty(), "-resume requires -checkpoint <filename>");
 }
 
 int main(int argc, char **argv)
@@ -47,8 +47,8 @@ struct Options
   Options()
       : action(ACTION_LLL), method(LM_WRAPPER), int_type(ZT_MPZ), float_type(FT_DEFAULT),
         delta(LLL_DEF_DELTA), eta(LLL_DEF_ETA), precision(0), early_red(false), siegel(false),
-        no_lll(false), block_size(0), bkz_gh_factor(1.1), verbose(false), input_file(NULL),
-        output_format(NULL)
+        no_lll(false), block_size(0), bkz_gh_factor(1.1), resume(false), verbose(false),
+        input_file(NULL), output_format(NULL)
   {
     bkz_flags     = 0;
     bkz_max_loops = 0;
@@ -72,6 +72,8 @@ struct Options
   string bkz_dump_gso_filename;
   double bkz_gh_factor;
   string bkz_strategy_file;
+  string checkpoint_file;
+  bool resume;
 
   bool verbose;
   const char *input_file;
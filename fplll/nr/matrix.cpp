@@ -25,30 +25,36 @@ FPLLL_BEGIN_NAMESPACE
 
 template <class T> void Matrix<T>::resize(int rows, int cols)
 {
-  int old_size = matrix.size();
-  if (old_size < rows)
-  {
-    vector<NumVect<T>> m2(max(old_size * 2, rows));
-    for (int i = 0; i < old_size; i++)
+  int old_rows = row_pos.size();
+  if (rows > old_rows || cols > stride)
+  {
+    /* The capacity is at least doubled, and rows are padded to a multiple of MATRIX_ALIGNMENT
+       bytes when the size of T allows it */
+    int new_rows   = rows > old_rows ? max(old_rows * 2, rows) : old_rows;
+    int new_stride = cols > stride ? max(stride * 2, cols) : stride;
+    if (MATRIX_ALIGNMENT % sizeof(T) == 0)
     {
-      matrix[i].swap(m2[i]);
+      int row_align = MATRIX_ALIGNMENT / sizeof(T);
+      new_stride    = (new_stride + row_align - 1) / row_align * row_align;
     }
-    matrix.swap(m2);
-  }
-  for (int i = r; i < rows; i++)
-  {
-    matrix[i].resize(cols);
-  }
-  if (cols != c)
-  {
-    for (int i = min(r, rows) - 1; i >= 0; i--)
+    vector<T, MatrixAllocator<T>> new_storage(static_cast<size_t>(new_rows) * new_stride);
+    for (int i = 0; i < min(r, rows); i++)
+    {
+      for (int j = 0; j < min(c, cols); j++)
+      {
+        new_storage[i * new_stride + j].swap(storage[row_pos[i] * stride + j]);
+      }
+    }
+    storage.swap(new_storage);
+    row_pos.resize(new_rows);
+    for (int i = 0; i < new_rows; i++)
     {
-      matrix[i].resize(cols);
+      row_pos[i] = i;
     }
+    stride = new_stride;
   }
-  r    = rows;
-  c    = cols;
-  cols = c;
+  r = rows;
+  c = cols;
 }
 
 template <class T> template <class U> void Matrix<T>::fill(U value)
@@ -57,7 +63,7 @@ template <class T> template <class U> void Matrix<T>::fill(U value)
   {
     for (int j = 0; j < c; j++)
     {
-      matrix[i][j] = value;
+      (*this)(i, j) = value;
     }
   }
 }
@@ -65,14 +71,17 @@ template <class T> template <class U> void Matrix<T>::fill(U value)
 template <class T> void Matrix<T>::rotate_gram_left(int first, int last, int n_valid_rows)
 {
   FPLLL_DEBUG_CHECK(0 <= first && first <= last && last < n_valid_rows && n_valid_rows <= r);
-  matrix[first][first].swap(matrix[first][last]);
+  (*this)(first, first).swap((*this)(first, last));
   for (int i = first; i < last; i++)
   {
-    matrix[i + 1][first].swap(matrix[first][i]);
+    (*this)(i + 1, first).swap((*this)(first, i));
   }
   for (int i = first; i < n_valid_rows; i++)
   {
-    matrix[i].rotate_left(first, min(last, i));  // most expensive step
+    // most expensive step
+    T *row = &(*this)(i, 0);
+    for (int j = first; j < min(last, i); j++)
+      row[j].swap(row[j + 1]);
   }
   rotate_left(first, last);
 }
@@ -83,32 +92,29 @@ template <class T> void Matrix<T>::rotate_gram_right(int first, int last, int n_
   rotate_right(first, last);
   for (int i = first; i < n_valid_rows; i++)
   {
-    matrix[i].rotate_right(first, min(last, i));  // most expensive step
+    // most expensive step
+    T *row = &(*this)(i, 0);
+    for (int j = min(last, i) - 1; j >= first; j--)
+      row[j].swap(row[j + 1]);
   }
   for (int i = first; i < last; i++)
   {
-    matrix[i + 1][first].swap(matrix[first][i]);
+    (*this)(i + 1, first).swap((*this)(first, i));
   }
-  matrix[first][first].swap(matrix[first][last]);
+  (*this)(first, first).swap((*this)(first, last));
 }
 
 template <class T> void Matrix<T>::transpose()
 {
-  extend_vect(matrix, c);
-  for (int i = 0; i < c; i++)
-  {
-    matrix[i].extend(r);
-  }
-  for (int i = 0; i < min(r, c); i++)
+  Matrix<T> m(c, r);
+  for (int i = 0; i < r; i++)
   {
-    for (int j = i + 1; j < max(r, c); j++)
+    for (int j = 0; j < c; j++)
     {
-      matrix[i][j].swap(matrix[j][i]);
+      m(j, i).swap((*this)(i, j));
     }
-    if (c > r)
-      matrix[i].resize(r);
   }
-  std::swap(r, c);
+  swap(m);
 }
 
 template <class T> T Matrix<T>::get_max()
@@ -118,7 +124,7 @@ template <class T> T Matrix<T>::get_max()
   for (int i = 0; i < r; i++)
     for (int j = 0; j < c; j++)
     {
-      a.abs(matrix[i][j]);
+      a.abs((*this)(i, j));
       m = max(m, a);
     }
   return m;
@@ -129,7 +135,7 @@ template <class T> long Matrix<T>::get_max_exp()
   long max_exp = 0;
   for (int i = 0; i < r; i++)
     for (int j = 0; j < c; j++)
-      max_exp = max(max_exp, matrix[i][j].exponent());
+      max_exp = max(max_exp, (*this)(i, j).exponent());
   return max_exp;
 }
 
@@ -149,7 +155,7 @@ template <class T> void Matrix<T>::print(ostream &os, int nrows, int ncols) cons
     {
       if (j > 0)
         os << ' ';
-      os << matrix[i][j];
+      os << (*this)(i, j);
     }
     if (print_mode == MAT_PRINT_REGULAR && ncols > 0)
       os << ' ';
@@ -163,7 +169,8 @@ template <class T> void Matrix<T>::print(ostream &os, int nrows, int ncols) cons
 template <class T> void Matrix<T>::read(istream &is)
 {
   char ch;
-  matrix.clear();
+  vector<NumVect<T>> rows;
+  clear();
   if (!(is >> ch))
     return;
   if (ch != '[')
@@ -174,30 +181,121 @@ template <class T> void Matrix<T>::read(istream &is)
   while (is >> ch && ch != ']')
   {
     is.putback(ch);
-    matrix.resize(matrix.size() + 1);
-    if (!(is >> matrix.back()))
+    rows.resize(rows.size() + 1);
+    if (!(is >> rows.back()))
     {
-      matrix.pop_back();
+      rows.pop_back();
       break;
     }
   }
 
-  r = matrix.size();
-  c = 0;
-  for (int i = 0; i < r; i++)
+  int cols = 0;
+  for (size_t i = 0; i < rows.size(); i++)
   {
-    c = max(c, matrix[i].size());
+    cols = max(cols, rows[i].size());
   }
+  resize(rows.size(), cols);
   for (int i = 0; i < r; i++)
   {
-    int old_c = matrix[i].size();
-    if (old_c < c)
+    int old_c = rows[i].size();
+    for (int j = 0; j < old_c; j++)
     {
-      matrix[i].resize(c);
-      for (int j = old_c; j < c; j++)
-      {
-        matrix[i][j] = 0;
-      }
+      (*this)(i, j).swap(rows[i][j]);
+    }
+    for (int j = old_c; j < c; j++)
+    {
+      (*this)(i, j) = 0;
+    }
+  }
+}
+
+/* TriangularMatrix */
+
+template <class T> void TriangularMatrix<T>::resize(int rows)
+{
+  if (rows > alloc_rows)
+  {
+    // Rows are kept at the same place, so the capacity is doubled as for Matrix
+    int new_rows = max(alloc_rows * 2, rows);
+    vector<T, MatrixAllocator<T>> new_storage(row_start(new_rows));
+    for (size_t k = 0; k < row_start(n); k++)
+    {
+      new_storage[k].swap(storage[k]);
+    }
+    storage.swap(new_storage);
+    alloc_rows = new_rows;
+  }
+  n = rows;
+}
+
+template <class T> void TriangularMatrix<T>::rotate_left(int first, int last)
+{
+  FPLLL_DEBUG_CHECK(0 <= first && first <= last && last < n);
+  for (int i = first; i < last; i++)
+  {
+    T *row = &storage[row_start(i)], *next_row = &storage[row_start(i + 1)];
+    for (int j = 0; j <= first; j++)
+      row[j].swap(next_row[j]);
+  }
+}
+
+template <class T> void TriangularMatrix<T>::rotate_right(int first, int last)
+{
+  FPLLL_DEBUG_CHECK(0 <= first && first <= last && last < n);
+  for (int i = last - 1; i >= first; i--)
+  {
+    T *row = &storage[row_start(i)], *next_row = &storage[row_start(i + 1)];
+    for (int j = 0; j <= first; j++)
+      row[j].swap(next_row[j]);
+  }
+}
+
+template <class T> void TriangularMatrix<T>::swap_gram(int k, int n_valid_rows)
+{
+  T *row = &storage[row_start(k)], *next_row = &storage[row_start(k + 1)];
+  for (int j = 0; j < k; j++)
+  {
+    row[j].swap(next_row[j]);
+  }
+  row[k].swap(next_row[k + 1]);
+  for (int i = k + 2; i < n_valid_rows; i++)
+  {
+    storage[row_start(i) + k].swap(storage[row_start(i) + k + 1]);
+  }
+}
+
+template <class T>
+void TriangularMatrix<T>::rotate_gram_left(int first, int last, int n_valid_rows)
+{
+  FPLLL_DEBUG_CHECK(0 <= first && first <= last && last < n_valid_rows && n_valid_rows <= n);
+  for (int k = first; k < last; k++)
+  {
+    swap_gram(k, n_valid_rows);
+  }
+}
+
+template <class T>
+void TriangularMatrix<T>::rotate_gram_right(int first, int last, int n_valid_rows)
+{
+  FPLLL_DEBUG_CHECK(0 <= first && first <= last && last < n_valid_rows && n_valid_rows <= n);
+  for (int k = last - 1; k >= first; k--)
+  {
+    swap_gram(k, n_valid_rows);
+  }
+}
+
+template <class T> void TriangularMatrix<T>::to_matrix(Matrix<T> &m) const
+{
+  m.resize(n, n);
+  for (int i = 0; i < n; i++)
+  {
+    for (int j = 0; j <= i; j++)
+    {
+      m(i, j) = (*this)(i, j);
+    }
+    for (int j = i + 1; j < n; j++)
+    {
+      m(i, j) = 0.0;
     }
   }
 }
@@ -214,15 +312,15 @@ template <class ZT> inline void ZZ_mat<ZT>::gen_intrel(int bits)
   int i, j;
   for (i = 0; i < r; i++)
   {
-    matrix[i][0].randb(bits);
+    (*this)(i, 0).randb(bits);
     for (j = 1; j <= i; j++)
     {
-      matrix[i][j] = 0;
+      (*this)(i, j) = 0;
     }
-    matrix[i][i + 1] = 1;
+    (*this)(i, i + 1) = 1;
     for (j = i + 2; j < c; j++)
     {
-      matrix[i][j] = 0;
+      (*this)(i, j) = 0;
     }
   }
 }
@@ -236,18 +334,18 @@ template <class ZT> inline void ZZ_mat<ZT>::gen_simdioph(int bits, int bits2)
   }
   int i, j;
 
-  matrix[0][0] = 1;
-  matrix[0][0].mul_2si(matrix[0][0], bits2);
+  (*this)(0, 0) = 1;
+  (*this)(0, 0).mul_2si((*this)(0, 0), bits2);
   for (i = 1; i < r; i++)
-    matrix[0][i].randb(bits);
+    (*this)(0, i).randb(bits);
   for (i = 1; i < r; i++)
   {
-    for (j         = 1; j < i; j++)
-      matrix[j][i] = 0;
-    matrix[i][i]   = 1;
-    matrix[i][i].mul_2si(matrix[i][i], bits);
-    for (j         = i + 1; j < c; j++)
-      matrix[j][i] = 0;
+    for (j          = 1; j < i; j++)
+      (*this)(j, i) = 0;
+    (*this)(i, i)   = 1;
+    (*this)(i, i).mul_2si((*this)(i, i), bits);
+    for (j          = i + 1; j < c; j++)
+      (*this)(j, i) = 0;
   }
 }
 
@@ -260,7 +358,7 @@ template <class ZT> inline void ZZ_mat<ZT>::gen_uniform(int bits)
   }
   for (int i = 0; i < r; i++)
     for (int j = 0; j < c; j++)
-      matrix[i][j].randb(bits);
+      (*this)(i, j).randb(bits);
 }
 
 template <class ZT> inline void ZZ_mat<ZT>::gen_ntrulike(int bits)
@@ -296,27 +394,27 @@ template <class ZT> inline void ZZ_mat<ZT>::gen_ntrulike(int bits)
   // I in A00
   for (i = 0; i < d; i++)
   {
-    for (j         = 0; j < i; j++)
-      matrix[i][j] = 0;
-    matrix[i][i]   = 1;
-    for (j         = i + 1; j < d; j++)
-      matrix[i][j] = 0;
+    for (j          = 0; j < i; j++)
+      (*this)(i, j) = 0;
+    (*this)(i, i)   = 1;
+    for (j          = i + 1; j < d; j++)
+      (*this)(i, j) = 0;
   }
 
   // 0 in A10
   for (i = d; i < r; i++)
   {
-    for (j         = 0; j < d; j++)
-      matrix[i][j] = 0;
+    for (j          = 0; j < d; j++)
+      (*this)(i, j) = 0;
   }
   // qI in A11
   for (i = d; i < r; i++)
   {
-    for (j         = d; j < i; j++)
-      matrix[i][j] = 0;
-    matrix[i][i]   = q;
-    for (j         = i + 1; j < c; j++)
-      matrix[i][j] = 0;
+    for (j          = d; j < i; j++)
+      (*this)(i, j) = 0;
+    (*this)(i, i)   = q;
+    for (j          = i + 1; j < c; j++)
+      (*this)(i, j) = 0;
   }
   // H in A01
   for (i = 0; i < d; i++)
@@ -327,7 +425,7 @@ template <class ZT> inline void ZZ_mat<ZT>::gen_ntrulike(int bits)
       {
         k += d;
       }
-      matrix[i][j] = h[k];
+      (*this)(i, j) = h[k];
     }
 
   delete[] h;
@@ -364,27 +462,27 @@ template <class ZT> inline void ZZ_mat<ZT>::gen_ntrulike_withq(int q)
   // I in A00
   for (i = 0; i < d; i++)
   {
-    for (j         = 0; j < i; j++)
-      matrix[i][j] = 0;
-    matrix[i][i]   = 1;
-    for (j         = i + 1; j < d; j++)
-      matrix[i][j] = 0;
+    for (j          = 0; j < i; j++)
+      (*this)(i, j) = 0;
+    (*this)(i, i)   = 1;
+    for (j          = i + 1; j < d; j++)
+      (*this)(i, j) = 0;
   }
 
   // 0 in A10
   for (i = d; i < r; i++)
   {
-    for (j         = 0; j < d; j++)
-      matrix[i][j] = 0;
+    for (j          = 0; j < d; j++)
+      (*this)(i, j) = 0;
   }
   // qI in A11
   for (i = d; i < r; i++)
   {
-    for (j         = d; j < i; j++)
-      matrix[i][j] = 0;
-    matrix[i][i]   = q2;
-    for (j         = i + 1; j < c; j++)
-      matrix[i][j] = 0;
+    for (j          = d; j < i; j++)
+      (*this)(i, j) = 0;
+    (*this)(i, i)   = q2;
+    for (j          = i + 1; j < c; j++)
+      (*this)(i, j) = 0;
   }
   // H in A01
   for (i = 0; i < d; i++)
@@ -395,7 +493,7 @@ template <class ZT> inline void ZZ_mat<ZT>::gen_ntrulike_withq(int q)
       {
         k += d;
       }
-      matrix[i][j] = h[k];
+      (*this)(i, j) = h[k];
     }
 
   delete[] h;
@@ -429,17 +527,17 @@ template <class ZT> inline void ZZ_mat<ZT>::gen_ntrulike2(int bits)
 
   for (i = 0; i < d; i++)
   {
-    for (j         = 0; j < c; j++)
-      matrix[i][j] = 0;
+    for (j          = 0; j < c; j++)
+      (*this)(i, j) = 0;
   }
 
   for (i         = 0; i < d; i++)
-    matrix[i][i] = q;
+    (*this)(i, i) = q;
   for (i = d; i < r; i++)
     for (j         = d; j < c; j++)
-      matrix[i][j] = 0;
+      (*this)(i, j) = 0;
   for (i         = d; i < c; i++)
-    matrix[i][i] = 1;
+    (*this)(i, i) = 1;
 
   for (i = d; i < r; i++)
   {
@@ -450,7 +548,7 @@ template <class ZT> inline void ZZ_mat<ZT>::gen_ntrulike2(int bits)
       {
         k += d;
       }
-      matrix[i][j] = h[k];
+      (*this)(i, j) = h[k];
     }
   }
 
@@ -485,17 +583,17 @@ template <class ZT> inline void ZZ_mat<ZT>::gen_ntrulike2_withq(int q)
 
   for (i = 0; i < d; i++)
   {
-    for (j         = 0; j < c; j++)
-      matrix[i][j] = 0;
+    for (j          = 0; j < c; j++)
+      (*this)(i, j) = 0;
   }
 
   for (i         = 0; i < d; i++)
-    matrix[i][i] = q2;
+    (*this)(i, i) = q2;
   for (i = d; i < r; i++)
     for (j         = d; j < c; j++)
-      matrix[i][j] = 0;
+      (*this)(i, j) = 0;
   for (i         = d; i < c; i++)
-    matrix[i][i] = 1;
+    (*this)(i, i) = 1;
 
   for (i = d; i < r; i++)
   {
@@ -506,7 +604,7 @@ template <class ZT> inline void ZZ_mat<ZT>::gen_ntrulike2_withq(int q)
       {
         k += d;
       }
-      matrix[i][j] = h[k];
+      (*this)(i, j) = h[k];
     }
   }
 
@@ -525,21 +623,21 @@ template <class ZT> inline void ZZ_mat<ZT>::gen_qary(int k, Z_NR<ZT> &q)
 
   for (i = 0; i < d - k; i++)
     for (j         = 0; j < d - k; j++)
-      matrix[i][j] = 0;
+      (*this)(i, j) = 0;
 
-  for (i         = 0; i < d - k; i++)
-    matrix[i][i] = 1;
+  for (i          = 0; i < d - k; i++)
+    (*this)(i, i) = 1;
 
   for (i = 0; i < d - k; i++)
     for (j = d - k; j < d; j++)
-      matrix[i][j].randm(q);
+      (*this)(i, j).randm(q);
 
   for (i = d - k; i < d; i++)
     for (j         = 0; j < d - k; j++)
-      matrix[i][j] = 0;
+      (*this)(i, j) = 0;
 
-  for (i         = d - k; i < d; i++)
-    matrix[i][i] = q;
+  for (i          = d - k; i < d; i++)
+    (*this)(i, i) = q;
 }
 
 template <class ZT> inline void ZZ_mat<ZT>::gen_trg(double alpha)
@@ -563,16 +661,16 @@ template <class ZT> inline void ZZ_mat<ZT>::gen_trg(double alpha)
     ztmp = 1;
     ztmp.mul_2si(ztmp, bits);
     ztmp.sub(ztmp, zone);
-    matrix[i][i].randm(ztmp);
-    matrix[i][i].add_ui(matrix[i][i], 2);
-    ztmp.div_2si(matrix[i][i], 1);
+    (*this)(i, i).randm(ztmp);
+    (*this)(i, i).add_ui((*this)(i, i), 2);
+    ztmp.div_2si((*this)(i, i), 1);
     for (j = i + 1; j < d; j++)
     {
-      matrix[j][i].randm(ztmp);
+      (*this)(j, i).randm(ztmp);
       sign.randb(1);
       if (sign == 1)
-        matrix[j][i].sub(ztmp2, matrix[j][i]);
-      matrix[i][j] = 0;
+        (*this)(j, i).sub(ztmp2, (*this)(j, i));
+      (*this)(i, j) = 0;
     }
   }
 }
@@ -591,17 +689,17 @@ template <class ZT> inline void ZZ_mat<ZT>::gen_trg2(FP_NR<mpfr_t> *w)
 
   for (i = 0; i < d; i++)
   {
-    matrix[i][i].set_f(w[i]);
-    ztmp.div_2si(matrix[i][i], 1);
+    (*this)(i, i).set_f(w[i]);
+    ztmp.div_2si((*this)(i, i), 1);
     ztmp2 = 1;
     ztmp.add(ztmp, ztmp2);
     for (j = i + 1; j < d; j++)
     {
       ztmp2 = 0;
-      matrix[j][i].randm(ztmp);
+      (*this)(j, i).randm(ztmp);
       if (rand() % 2 == 1)
-        matrix[j][i].sub(ztmp2, matrix[j][i]);
-      matrix[i][j] = 0;
+        (*this)(j, i).sub(ztmp2, (*this)(j, i));
+      (*this)(i, j) = 0;
     }
   }
 }
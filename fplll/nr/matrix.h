@@ -29,9 +29,11 @@ enum MatPrintMode
 };
 
 template <class T> class Matrix;
+template <class T> class TriangularMatrix;
 
 /** MatrixRow stores a reference to a row of a Matrix. It supports a subset
-    of operations available on vectors. */
+    of operations available on vectors. It stays valid until the matrix is
+    resized or its rows are permuted. */
 template <class T> class MatrixRow
 {
 public:
@@ -41,47 +43,141 @@ public:
       objects. */
   const T &operator[](int i) const { return row[i]; }
   /** Returns the number of columns. */
-  int size() const { return row.size(); }
+  int size() const { return n; }
   /** Prints this object on stream os. */
-  void print(ostream &os) const { os << row; }
-
-  bool is_zero(int from = 0) const { return row.is_zero(from); }
-  int size_nz() const { return row.size_nz(); }
-  void fill(long value) { row.fill(value); }
-  void add(const MatrixRow<T> &v) { row.add(v.row); }
-  void add(const MatrixRow<T> &v, int n) { row.add(v.row, n); }
-  void sub(const MatrixRow<T> &v) { row.sub(v.row); }
-  void sub(const MatrixRow<T> &v, int n) { row.sub(v.row, n); }
-  void addmul(const MatrixRow<T> &v, T x) { row.addmul(v.row, x); }
-  void addmul(const MatrixRow<T> &v, T x, int n) { row.addmul(v.row, x, n); }
+  void print(ostream &os) const
+  {
+    os << "[";
+    for (int i = 0; i < n; i++)
+    {
+      if (i > 0)
+        os << " ";
+      os << row[i];
+    }
+    os << "]";
+  }
+
+  bool is_zero(int from = 0) const
+  {
+    for (int i = from; i < n; i++)
+    {
+      if (!row[i].is_zero())
+        return false;
+    }
+    return true;
+  }
+  int size_nz() const
+  {
+    int i;
+    for (i = n; i > 0; i--)
+    {
+      if (row[i - 1] != 0)
+        break;
+    }
+    return i;
+  }
+  void fill(long value)
+  {
+    for (int i = 0; i < n; i++)
+      row[i] = value;
+  }
+  void add(const MatrixRow<T> &v) { add(v, n); }
+  void add(const MatrixRow<T> &v, int n)
+  {
+    FPLLL_DEBUG_CHECK(n <= size() && size() == v.size() && v.is_zero(n));
+    vect_add(row, v.row, n);
+  }
+  void sub(const MatrixRow<T> &v) { sub(v, n); }
+  void sub(const MatrixRow<T> &v, int n)
+  {
+    FPLLL_DEBUG_CHECK(n <= size() && size() == v.size() && v.is_zero(n));
+    vect_sub(row, v.row, n);
+  }
+  void addmul(const MatrixRow<T> &v, T x) { addmul(v, x, n); }
+  void addmul(const MatrixRow<T> &v, T x, int n)
+  {
+    FPLLL_DEBUG_CHECK(n <= size() && size() == v.size() && v.is_zero(n));
+    vect_addmul(row, v.row, x, n);
+  }
   void addmul_2exp(const MatrixRow<T> &v, const T &x, long expo, T &tmp)
   {
-    row.addmul_2exp(v.row, x, expo, tmp);
+    addmul_2exp(v, x, expo, n, tmp);
+  }
+  void addmul_2exp(const MatrixRow<T> &v, const T &x, long expo, int n, T &tmp)
+  {
+    FPLLL_DEBUG_CHECK(n <= size() && size() == v.size() && v.is_zero(n));
+    vect_addmul_2exp(row, v.row, x, expo, n, tmp);
   }
-  void addmul_2exp(const MatrixRow<T> &v, const T &x, long expo, int /*n*/, T &tmp)
+  void addmul_si(const MatrixRow<T> &v, long x) { addmul_si(v, x, n); }
+  void addmul_si(const MatrixRow<T> &v, long x, int n)
   {
-    row.addmul_2exp(v.row, x, expo, tmp);
+    FPLLL_DEBUG_CHECK(n <= size() && size() == v.size() && v.is_zero(n));
+    vect_addmul_si(row, v.row, x, n);
   }
-  void addmul_si(const MatrixRow<T> &v, long x) { row.addmul_si(v.row, x); }
-  void addmul_si(const MatrixRow<T> &v, long x, int n) { row.addmul_si(v.row, x, n); }
   void addmul_si_2exp(const MatrixRow<T> &v, long x, long expo, T &tmp)
   {
-    row.addmul_si_2exp(v.row, x, expo, tmp);
+    addmul_si_2exp(v, x, expo, n, tmp);
   }
   void addmul_si_2exp(const MatrixRow<T> &v, long x, long expo, int n, T &tmp)
   {
-    row.addmul_si_2exp(v.row, x, expo, n, tmp);
+    FPLLL_DEBUG_CHECK(n <= size() && size() == v.size() && v.is_zero(n));
+    vect_addmul_si_2exp(row, v.row, x, expo, n, tmp);
   }
 
-  NumVect<T> & get_underlying_row() const {return row;};
+  /** Returns this row. Rows are no longer stored as NumVect objects, but the row has the same
+      operations, which still modify the matrix. NumVect<T>(row) copies it. */
+  MatrixRow<T> &get_underlying_row() { return *this; }
+  const MatrixRow<T> &get_underlying_row() const { return *this; }
 
   friend class Matrix<T>;
+  friend class TriangularMatrix<T>;
+  friend class NumVect<T>;
 
 private:
-  MatrixRow(const NumVect<T> &row) : row(const_cast<NumVect<T> &>(row)) {}
-  NumVect<T> &row;
+  MatrixRow(const T *row, int n) : row(const_cast<T *>(row)), n(n) {}
+  T *row;
+  int n;
 };
 
+template <class T> NumVect<T>::NumVect(const MatrixRow<T> &row) : data(row.row, row.row + row.n)
+{
+}
+
+/** Allocator of the storage of Matrix. Buffers start on a multiple of
+    MATRIX_ALIGNMENT bytes. */
+template <class T> class MatrixAllocator
+{
+public:
+  typedef T value_type;
+
+  MatrixAllocator() {}
+  template <class U> MatrixAllocator(const MatrixAllocator<U> &) {}
+
+  T *allocate(size_t n)
+  {
+    // The address returned by operator new is stored just before the aligned buffer
+    char *base = static_cast<char *>(::operator new(n * sizeof(T) + MATRIX_ALIGNMENT +
+                                                    sizeof(void *)));
+    size_t p   = reinterpret_cast<size_t>(base + sizeof(void *));
+    p          = (p + MATRIX_ALIGNMENT - 1) & ~static_cast<size_t>(MATRIX_ALIGNMENT - 1);
+    reinterpret_cast<void **>(p)[-1] = base;
+    return reinterpret_cast<T *>(p);
+  }
+  void deallocate(T *p, size_t) { ::operator delete(reinterpret_cast<void **>(p)[-1]); }
+};
+
+template <class T, class U>
+bool operator==(const MatrixAllocator<T> &, const MatrixAllocator<U> &)
+{
+  return true;
+}
+
+template <class T, class U>
+bool operator!=(const MatrixAllocator<T> &, const MatrixAllocator<U> &)
+{
+  return false;
+}
+
 template <class T>
 void dot_product(T &result, const MatrixRow<T> &v1, const MatrixRow<T> &v2, int n)
 {
@@ -110,21 +206,26 @@ template <class T> ostream &operator<<(ostream &os, const MatrixRow<T> &row)
 /** Matrix is a two-dimensional container. Read and write operations on single
     elements are in constant time. The amortized complexity of resizing the
     matrix is proportional to the number of added/removed elements. All indices
-    are 0-based. */
+    are 0-based.
+
+    The elements are stored row by row in a single buffer. Rows start on a
+    multiple of MATRIX_ALIGNMENT bytes and row permutations only permute the
+    positions of the rows in the buffer. */
 template <class T> class Matrix
 {
 public:
   /** Creates an empty matrix (0 x 0). */
-  Matrix() : r(0), c(0) {}
+  Matrix() : r(0), c(0), stride(0) {}
   /** Creates a matrix of dimensions rows x cols. All elements are
       initialized with the default constructor of T. */
-  Matrix(int rows, int cols) : r(0), c(0) { resize(rows, cols); }
+  Matrix(int rows, int cols) : r(0), c(0), stride(0) { resize(rows, cols); }
 
   /** Sets number of rows and the number of columns to 0. */
   void clear()
   {
-    r = c = 0;
-    matrix.clear();
+    r = c = stride = 0;
+    storage.clear();
+    row_pos.clear();
   }
   /** Returns true if the matrix has 0 rows, false otherwise. */
   bool empty() const { return r == 0; }
@@ -142,9 +243,11 @@ public:
   /** Efficiently swaps two matrices. */
   void swap(Matrix<T> &m)
   {
-    matrix.swap(m.matrix);
+    storage.swap(m.storage);
+    row_pos.swap(m.row_pos);
     std::swap(r, m.r);
     std::swap(c, m.c);
+    std::swap(stride, m.stride);
   }
 
   /** Returns the number of rows */
@@ -155,39 +258,48 @@ public:
   T &operator()(int i, int j)
   {
     FPLLL_DEBUG_CHECK(i >= 0 && i < r && j >= 0 && j < c);
-    return matrix[i][j];
+    return storage[row_pos[i] * stride + j];
   }
   /** Returns a constant reference to the element (i, j) on constant objects. */
   const T &operator()(int i, int j) const
   {
     FPLLL_DEBUG_CHECK(i >= 0 && i < r && j >= 0 && j < c);
-    return matrix[i][j];
+    return storage[row_pos[i] * stride + j];
   }
   /** Returns a MatrixRow object pointing to the i-th row of this matrix. */
   MatrixRow<T> operator[](int i)
   {
     FPLLL_DEBUG_CHECK(i >= 0 && i < r);
-    return MatrixRow<T>(matrix[i]);
+    return MatrixRow<T>(&storage[row_pos[i] * stride], c);
   }
   /** Returns a MatrixRow object pointing to the i-th row of this matrix
       on constant objects. */
   const MatrixRow<T> operator[](int i) const
   {
     FPLLL_DEBUG_CHECK(i >= 0 && i < r);
-    return MatrixRow<T>(matrix[i]);
+    return MatrixRow<T>(&storage[row_pos[i] * stride], c);
   }
   /** Rows swap. */
-  void swap_rows(int r1, int r2) { matrix[r1].swap(matrix[r2]); }
+  void swap_rows(int r1, int r2) { std::swap(row_pos[r1], row_pos[r2]); }
   /** Rows permutation.
       (m[first],...,m[last]) becomes (m[first+1],...,m[last],m[first]) */
-  void rotate_left(int first, int last) { rotate_left_by_swap(matrix, first, last); }
+  void rotate_left(int first, int last)
+  {
+    std::rotate(row_pos.begin() + first, row_pos.begin() + first + 1, row_pos.begin() + last + 1);
+  }
   /** Rows permutation.
       (m[first],...,m[last]) becomes (m[last],m[first],...,m[last-1]) */
-  void rotate_right(int first, int last) { rotate_right_by_swap(matrix, first, last); }
+  void rotate_right(int first, int last)
+  {
+    std::rotate(row_pos.begin() + first, row_pos.begin() + last, row_pos.begin() + last + 1);
+  }
   /** Rows permutation.
       (m[first],...,m[middle-1],m[middle],m[last]) becomes
       (m[middle],...,m[last],m[first],...,m[middle-1]) */
-  void rotate(int first, int middle, int last) { rotate_by_swap(matrix, first, middle, last); }
+  void rotate(int first, int middle, int last)
+  {
+    std::rotate(row_pos.begin() + first, row_pos.begin() + middle, row_pos.begin() + last + 1);
+  }
   /** Transformation needed to update the lower triangular Gram matrix when
      rotate_left(first, last) is done on the basis of the lattice. */
   void rotate_gram_left(int first, int last, int n_valid_rows);
@@ -215,7 +327,11 @@ public:
 
 protected:
   int r, c;
-  vector<NumVect<T>> matrix;
+  /* Row i is stored in storage[row_pos[i] * stride], ..., storage[row_pos[i] * stride + c - 1].
+     row_pos.size() rows and stride >= c columns are allocated. */
+  int stride;
+  vector<T, MatrixAllocator<T>> storage;
+  vector<int> row_pos;
 
   static int print_mode;
 };
@@ -241,7 +357,6 @@ public:
   typedef Z_NR<ZT> T;
   using Matrix<T>::r;
   using Matrix<T>::c;
-  using Matrix<T>::matrix;
   using Matrix<T>::resize;
   using Matrix<T>::get_cols;
   using Matrix<T>::get_rows;
@@ -257,14 +372,14 @@ public:
   {
     resize(d, n);
     for (int i = 0; i < d; i++)
-      matrix[i].fill(0);
+      (*this)[i].fill(0);
   }
 
   void gen_identity(int d)
   {
     gen_zero(d, d);
-    for (int i     = 0; i < d; i++)
-      matrix[i][i] = 1;
+    for (int i      = 0; i < d; i++)
+      (*this)(i, i) = 1;
   }
 
   void gen_intrel(int bits);
@@ -335,6 +450,77 @@ public:
   FP_mat(int rows, int cols) : Matrix<T>(rows, cols) {}
 };
 
+/** TriangularMatrix is a square matrix of which only the lower triangle, i.e. the elements (i, j)
+    with j <= i, is stored: row i is stored in i + 1 elements, right after row i - 1. Its rows
+    do not have the same length, hence it is not a Matrix, see to_matrix(). */
+template <class T> class TriangularMatrix
+{
+public:
+  /** Creates an empty matrix (0 x 0). */
+  TriangularMatrix() : n(0), alloc_rows(0) {}
+  /** Creates a matrix of dimensions n x n. */
+  TriangularMatrix(int n) : n(0), alloc_rows(0) { resize(n); }
+
+  /** Sets the dimensions of this matrix to n x n, preserving the content of
+      the remaining rows. The value of new elements is undefined. */
+  void resize(int n);
+  /** Returns the number of rows */
+  int get_rows() const { return n; }
+  /** Returns the number of columns */
+  int get_cols() const { return n; }
+  /** Returns a reference to the element (i, j), j <= i. */
+  T &operator()(int i, int j)
+  {
+    FPLLL_DEBUG_CHECK(i >= 0 && i < n && j >= 0 && j <= i);
+    return storage[row_start(i) + j];
+  }
+  /** Returns a constant reference to the element (i, j), j <= i, on constant objects. */
+  const T &operator()(int i, int j) const
+  {
+    FPLLL_DEBUG_CHECK(i >= 0 && i < n && j >= 0 && j <= i);
+    return storage[row_start(i) + j];
+  }
+  /** Returns a MatrixRow object pointing to the elements 0, ..., i of the
+      i-th row of this matrix. */
+  MatrixRow<T> operator[](int i)
+  {
+    FPLLL_DEBUG_CHECK(i >= 0 && i < n);
+    return MatrixRow<T>(&storage[row_start(i)], i + 1);
+  }
+  /** Returns a MatrixRow object pointing to the elements 0, ..., i of the
+      i-th row of this matrix on constant objects. */
+  const MatrixRow<T> operator[](int i) const
+  {
+    FPLLL_DEBUG_CHECK(i >= 0 && i < n);
+    return MatrixRow<T>(&storage[row_start(i)], i + 1);
+  }
+  /** Rows permutation on the columns 0, ..., first, which are stored in all
+      these rows. (m[first],...,m[last]) becomes (m[first+1],...,m[last],m[first]) */
+  void rotate_left(int first, int last);
+  /** Rows permutation on the columns 0, ..., first, which are stored in all
+      these rows. (m[first],...,m[last]) becomes (m[last],m[first],...,m[last-1]) */
+  void rotate_right(int first, int last);
+  /** Transformation needed to update the lower triangular Gram matrix when
+      rotate_left(first, last) is done on the basis of the lattice. */
+  void rotate_gram_left(int first, int last, int n_valid_rows);
+  /** Transformation needed to update the lower triangular Gram matrix when
+      rotate_right(first, last) is done on the basis of the lattice. */
+  void rotate_gram_right(int first, int last, int n_valid_rows);
+  /** Copies this matrix to the n x n matrix m, with zeros above the diagonal. */
+  void to_matrix(Matrix<T> &m) const;
+
+private:
+  int n;
+  /* Storage of alloc_rows rows */
+  int alloc_rows;
+  vector<T, MatrixAllocator<T>> storage;
+
+  /** Index of the element (i, 0) in storage. */
+  static size_t row_start(int i) { return static_cast<size_t>(i) * (i + 1) / 2; }
+  /* Update of the Gram matrix when the vectors k and k + 1 of the basis are swapped */
+  void swap_gram(int k, int n_valid_rows);
+};
+
 typedef ZZ_mat<IntegerT> IntMatrix;
 typedef FP_mat<FloatT> FloatMatrix;
 
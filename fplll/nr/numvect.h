@@ -115,6 +115,7 @@ template <class T> void gen_zero_vect(vector<T> &v, int n)
 }
 
 template <class T> class NumVect;
+template <class T> class MatrixRow;
 
 template <class T> ostream &operator<<(ostream &os, const NumVect<T> &v);
 
@@ -130,6 +131,8 @@ public:
   NumVect(NumVect &&v) : data() {swap(v);} //move constructor
   NumVect(int size) : data(size) {}  // Initial content is undefined
   NumVect(int size, const T &t) : data(size, t) {}
+  /** Copy of a row of a Matrix (see matrix.h) */
+  explicit NumVect(const MatrixRow<T> &row);
 
   /* old assignment operator */
   //void operator=(const NumVect &v)
@@ -230,18 +233,135 @@ protected:
   vector<T> data;
 };
 
+/* Operations on the first n elements of two arrays, shared by NumVect and MatrixRow */
+
+template <class T> inline void vect_add(T *a, const T *b, int n)
+{
+  for (int i = n - 1; i >= 0; i--)
+    a[i].add(a[i], b[i]);
+}
+
+template <class T> inline void vect_sub(T *a, const T *b, int n)
+{
+  for (int i = n - 1; i >= 0; i--)
+    a[i].sub(a[i], b[i]);
+}
+
+template <class T> inline void vect_addmul(T *a, const T *b, const T &x, int n)
+{
+  for (int i = n - 1; i >= 0; i--)
+    a[i].addmul(b[i], x);
+}
+
+template <class T>
+inline void vect_addmul_2exp(T *a, const T *b, const T &x, long expo, int n, T &tmp)
+{
+  for (int i = n - 1; i >= 0; i--)
+  {
+    tmp.mul(b[i], x);
+    tmp.mul_2si(tmp, expo);
+    a[i].add(a[i], tmp);
+  }
+}
+
+template <class T> inline void vect_addmul_si(T *a, const T *b, long x, int n)
+{
+  for (int i = n - 1; i >= 0; i--)
+    a[i].addmul_si(b[i], x);
+}
+
+template <class T>
+inline void vect_addmul_si_2exp(T *a, const T *b, long x, long expo, int n, T &tmp)
+{
+  for (int i = n - 1; i >= 0; i--)
+  {
+    tmp.mul_si(b[i], x);
+    tmp.mul_2si(tmp, expo);
+    a[i].add(a[i], tmp);
+  }
+}
+
+/* Row operations on machine words: with the power of 2 applied to x once, and without going through
+   tmp, the loops are vectorized by the compiler. */
+
+#ifdef FPLLL_WITH_ZLONG
+template <>
+inline void vect_addmul_si_2exp(Z_NR<long> *a, const Z_NR<long> *b, long x, long expo, int n,
+                                Z_NR<long> & /*tmp*/)
+{
+  if (expo >= 0)
+  {
+    // same as (b[i] * x) << expo modulo 2^CPU_SIZE
+    long y = static_cast<long>(static_cast<unsigned long>(x) << expo);
+    for (int i = 0; i < n; i++)
+      a[i].get_data() += b[i].get_data() * y;
+  }
+  else
+  {
+    for (int i = 0; i < n; i++)
+      a[i].get_data() += (b[i].get_data() * x) >> -expo;
+  }
+}
+
+template <>
+inline void vect_addmul_2exp(Z_NR<long> *a, const Z_NR<long> *b, const Z_NR<long> &x, long expo,
+                             int n, Z_NR<long> &tmp)
+{
+  vect_addmul_si_2exp(a, b, x.get_data(), expo, n, tmp);
+}
+#endif
+
+#ifdef FPLLL_WITH_ZDOUBLE
+template <>
+inline void vect_addmul_si_2exp(Z_NR<double> *a, const Z_NR<double> *b, long x, long expo, int n,
+                                Z_NR<double> &tmp)
+{
+  // b[i] * (x * 2^expo) is rounded as (b[i] * x) * 2^expo when x * 2^expo is a normal number
+  double y = ldexp(static_cast<double>(x), expo);
+  if (!std::isnormal(y))
+  {
+    for (int i = 0; i < n; i++)
+    {
+      tmp.mul_si(b[i], x);
+      tmp.mul_2si(tmp, expo);
+      a[i].add(a[i], tmp);
+    }
+    return;
+  }
+  for (int i = 0; i < n; i++)
+    a[i].get_data() += b[i].get_data() * y;
+}
+
+template <>
+inline void vect_addmul_2exp(Z_NR<double> *a, const Z_NR<double> *b, const Z_NR<double> &x,
+                             long expo, int n, Z_NR<double> &tmp)
+{
+  double y = ldexp(x.get_data(), expo);
+  if (!std::isnormal(y))
+  {
+    for (int i = 0; i < n; i++)
+    {
+      tmp.mul(b[i], x);
+      tmp.mul_2si(tmp, expo);
+      a[i].add(a[i], tmp);
+    }
+    return;
+  }
+  for (int i = 0; i < n; i++)
+    a[i].get_data() += b[i].get_data() * y;
+}
+#endif
+
 template <class T> void NumVect<T>::add(const NumVect<T> &v, int n)
 {
   FPLLL_DEBUG_CHECK(n <= size() && size() == v.size() && v.is_zero(n));
-  for (int i = n - 1; i >= 0; i--)
-    data[i].add(data[i], v[i]);
+  vect_add(data.data(), v.data.data(), n);
 }
 
 template <class T> void NumVect<T>::sub(const NumVect<T> &v, int n)
 {
   FPLLL_DEBUG_CHECK(n <= size() && size() == v.size() && v.is_zero(n));
-  for (int i = n - 1; i >= 0; i--)
-    data[i].sub(data[i], v[i]);
+  vect_sub(data.data(), v.data.data(), n);
 }
 
 template <class T> void NumVect<T>::mul(const NumVect<T> &v, int n, T c)
@@ -254,39 +374,27 @@ template <class T> void NumVect<T>::mul(const NumVect<T> &v, int n, T c)
 template <class T> void NumVect<T>::addmul(const NumVect<T> &v, T x, int n)
 {
   FPLLL_DEBUG_CHECK(n <= size() && size() == v.size() && v.is_zero(n));
-  for (int i = n - 1; i >= 0; i--)
-    data[i].addmul(v[i], x);
+  vect_addmul(data.data(), v.data.data(), x, n);
 }
 
 template <class T>
 void NumVect<T>::addmul_2exp(const NumVect<T> &v, const T &x, long expo, int n, T &tmp)
 {
   FPLLL_DEBUG_CHECK(n <= size() && size() == v.size() && v.is_zero(n));
-  for (int i = n - 1; i >= 0; i--)
-  {
-    tmp.mul(v[i], x);
-    tmp.mul_2si(tmp, expo);
-    data[i].add(data[i], tmp);
-  }
+  vect_addmul_2exp(data.data(), v.data.data(), x, expo, n, tmp);
 }
 
 template <class T> void NumVect<T>::addmul_si(const NumVect<T> &v, long x, int n)
 {
   FPLLL_DEBUG_CHECK(n <= size() && size() == v.size() && v.is_zero(n));
-  for (int i = n - 1; i >= 0; i--)
-    data[i].addmul_si(v[i], x);
+  vect_addmul_si(data.data(), v.data.data(), x, n);
 }
 
 template <class T>
 void NumVect<T>::addmul_si_2exp(const NumVect<T> &v, long x, long expo, int n, T &tmp)
 {
   FPLLL_DEBUG_CHECK(n <= size() && size() == v.size() && v.is_zero(n));
-  for (int i = n - 1; i >= 0; i--)
-  {
-    tmp.mul_si(v[i], x);
-    tmp.mul_2si(tmp, expo);
-    data[i].add(data[i], tmp);
-  }
+  vect_addmul_si_2exp(data.data(), v.data.data(), x, expo, n, tmp);
 }
 
 template <class T> long NumVect<T>::get_max_exponent()
@@ -280,7 +280,7 @@ inline FT Pruner<FT>::single_enum_cost(/*i*/ const evec &b, vector<double> *deta
     tmp /= symmetry_factor;
     if (detailed_cost)
     {
-      (*detailed_cost)[2 * d - (i + 1)] = tmp.get_d();
+      (*detailed_cost)[n - (i + 1)] = tmp.get_d();
     }
 
     total += tmp;
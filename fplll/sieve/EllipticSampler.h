@@ -37,7 +37,7 @@ void EllipticSampler<ET,MT,Engine,Sseq>::custom_init()
     Matrix<ET> u, u_inv; //intentionally uninitialized.
     MatGSO<ET, FP_NR<double> > GSO(current_basis, u, u_inv, MatGSOFlags::GSO_INT_GRAM);
     GSO.update_gso(); //todo: raise exception in case of error.
-    mu = GSO.get_mu_matrix();
+    GSO.get_mu_matrix().to_matrix(mu);
 //    g  = pGSO.get_g_matrix();
 //    F maxbistar2 = pGSO.get_max_bstar();
 //    F tmp;
@@ -64,7 +64,7 @@ LatticePoint<ET> EllipticSampler<ET,MT,Engine, Sseq>::sample(int thread)
     {
         long const newcoeff = GaussSieve::sample_z_gaussian_VMD<long,Engine>(s2pi,shifts[j],engine.rnd(),maxdeviations); //coefficient of b_j in vec.
         //vec+= current_basis[j].get_underlying_row(); //build up vector
-        vec.addmul_si(current_basis[j].get_underlying_row(), newcoeff);
+        vec.addmul_si(NumVect<ET>(current_basis[j]), newcoeff);
         for(int i=0;i<j;++i) //adjust shifts
         {
             shifts[i]-=newcoeff* (mu[j][i].get_d() );
@@ -95,8 +95,7 @@ void ExactLatticePoint<ET,nfixed>::normalize() //sets norm2 to the correct value
 //Convert MatrixRow to LatticePoint
 template <class ET,int nfixed> ExactLatticePoint<ET,nfixed> conv_matrixrow_to_lattice_point (MatrixRow<ET> const &row)
 {
-	ExactLatticePoint<ET,nfixed> res(row.get_underlying_row());
-	//NumVect<ET> tmp(row.get_underlying_row());
+	ExactLatticePoint<ET,nfixed> res{NumVect<ET>(row)};
 	return res;
 }
 
@@ -55,7 +55,7 @@ public:
 
     explicit MyLatticePoint(MatrixRow<ET> const & row)
     {
-        data = (row.get_underlying_row()).get();
+        data = NumVect<ET>(row).get();
         update_norm2();
         
     };
@@ -14,12 +14,12 @@ template<class ET,bool MT, class Engine, class Sseq, int nfixed> void ShiSampler
     MatGSO<ET, FP_NR<double> > GSO(current_basis, u, u_inv, MatGSOFlags::GSO_INT_GRAM);
     GSO.update_gso(); //todo: raise exception in case of error.
     
-    mu = GSO.get_mu_matrix();
+    GSO.get_mu_matrix().to_matrix(mu);
     
     s2pi.resize(rank);
     maxdeviations.resize(rank);
     
-    g  = GSO.get_g_matrix();
+    GSO.get_g_matrix().to_matrix(g);
     
     FP_NR<double> maxbistar2 = GSO.get_max_bstar();
     
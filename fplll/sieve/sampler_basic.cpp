@@ -24,9 +24,9 @@ template <class ZT, class F> KleinSampler<ZT, F>::KleinSampler(ZZ_mat<ZT> &B, bo
   pGSO = new MatGSO<Z_NR<ZT>, F>(b, u, u_inv, 1);
 
   pGSO->update_gso();
-  mu = pGSO->get_mu_matrix();
-  r  = pGSO->get_r_matrix();
-  g  = pGSO->get_g_matrix();
+  pGSO->get_mu_matrix().to_matrix(mu);
+  pGSO->get_r_matrix().to_matrix(r);
+  pGSO->get_g_matrix().to_matrix(g);
 
   /* compute variances for sampling */
   maxbistar2 = pGSO->get_max_bstar();
@@ -15,8 +15,13 @@
    along with fplll. If not, see <http://www.gnu.org/licenses/>. */
 
 #include "svpcvp.h"
+#include "bkz.h"
 #include "enum/enumerate.h"
 #include "enum/topenum.h"
+#include "pruner.h"
+#include <cmath>
+#include <mutex>
+#include <thread>
 
 FPLLL_BEGIN_NAMESPACE
 
@@ -28,7 +33,7 @@ FPLLL_BEGIN_NAMESPACE
    If b is LLL-reduced, then for any reasonnable dimension,
    max(rdiag[0],...,rdiag[i-1]) / min(rdiag[0],...,rdiag[i-1])
    is much smaller than numeric_limits<double>::max */
-static int last_useful_index(const Matrix<Float> &r)
+static int last_useful_index(const TriangularMatrix<Float> &r)
 {
   int i;
   Float rdiag_min_value;
@@ -58,11 +63,15 @@ static void get_basis_min(Integer &basis_min, const IntMatrix &b, int first, int
 }
 
 static bool enumerate_svp(int d, MatGSO<Integer, Float> &gso, Float &max_dist,
-                          ErrorBoundedEvaluator &evaluator, const vector<enumf> &pruning, int flags)
+                          ErrorBoundedEvaluator &evaluator, const vector<enumf> &pruning, int flags,
+                          const string &checkpoint_file)
 {
   Enumeration<Float> enumobj(gso, evaluator);
   bool dual = (flags & SVP_DUAL);
-  if (d == 1 || !pruning.empty() || dual)
+  // the checkpoints cover the whole tree, which is then enumerated at once
+  if (!checkpoint_file.empty())
+    enumobj.set_checkpoint(checkpoint_file, ENUM_CHECKPOINT_INTERVAL, flags & SVP_RESUME);
+  if (d == 1 || !pruning.empty() || dual || !checkpoint_file.empty())
   {
     enumobj.enumerate(0, d, max_dist, 0, vector<Float>(), vector<enumxt>(), pruning, dual);
   }
@@ -103,7 +112,8 @@ static int shortest_vector_ex(IntMatrix &b, IntVect &sol_coord, SVPMethod method
                               long long &sol_count, vector<IntVect> *subsol_coord = nullptr,
                               vector<enumf> *subsol_dist    = nullptr,
                               vector<IntVect> *auxsol_coord = nullptr,
-                              vector<enumf> *auxsol_dist = nullptr, int max_aux_sols = 0)
+                              vector<enumf> *auxsol_dist = nullptr, int max_aux_sols = 0,
+                              const string &checkpoint_file = string())
 {
   bool findsubsols = (subsol_coord != nullptr) && (subsol_dist != nullptr);
   bool findauxsols = (auxsol_coord != nullptr) && (auxsol_dist != nullptr) && (max_aux_sols != 0);
@@ -173,7 +183,9 @@ static int shortest_vector_ex(IntMatrix &b, IntVect &sol_coord, SVPMethod method
         d, b, gso.get_mu_matrix(), gso.get_r_matrix(), eval_mode, max_aux_sols + 1,
         EVALSTRATEGY_BEST_N_SOLUTIONS, findsubsols);
     p->int_max_dist = int_max_dist;
-    evaluator       = p;
+    if (flags & SVP_BATCH_VERIFY)
+      p->set_batch(EXACT_EVAL_BATCH_SIZE, true);
+    evaluator = p;
   }
   else
   {
@@ -190,7 +202,7 @@ static int shortest_vector_ex(IntMatrix &b, IntVect &sol_coord, SVPMethod method
   }
 
   // Main loop of the enumeration
-  enumerate_svp(d, gso, max_dist, *evaluator, pruning, flags);
+  enumerate_svp(d, gso, max_dist, *evaluator, pruning, flags, checkpoint_file);
 
   int result = RED_ENUM_FAILURE;
   if (eval_mode != EVALMODE_SV)
@@ -285,11 +297,173 @@ int shortest_vector_pruning(IntMatrix &b, IntVect &sol_coord, vector<IntVect> &a
   return shortest_vector_ex(b, sol_coord, SVPM_FAST, pruning, flags, EVALMODE_SV, tmp, nullptr,
                             nullptr, &auxsol_coord, &auxsol_dist, max_aux_sols);
 }
+
+int shortest_vector(IntMatrix &b, IntVect &sol_coord, const string &checkpoint_file,
+                    SVPMethod method, int flags)
+{
+  long long tmp;
+  return shortest_vector_ex(b, sol_coord, method, vector<double>(), flags, EVALMODE_SV, tmp,
+                            nullptr, nullptr, nullptr, nullptr, 0, checkpoint_file);
+}
+
+int shortest_vector_pruning(IntMatrix &b, IntVect &sol_coord, const vector<double> &pruning,
+                            const string &checkpoint_file, int flags)
+{
+  long long tmp;
+  return shortest_vector_ex(b, sol_coord, SVPM_FAST, pruning, flags, EVALMODE_SV, tmp, nullptr,
+                            nullptr, nullptr, nullptr, 0, checkpoint_file);
+}
+
+/* Extreme pruning
+   =============== */
+
+/* State shared by the threads of shortest_vector_extreme_pruning(). */
+struct ExtremePruningState
+{
+  ExtremePruningState(IntMatrix &b, double radius, const vector<double> &pruning, int max_trials,
+                      int prec)
+      : b(b), radius(radius), pruning(pruning), max_trials(max_trials), prec(prec), next_trial(0),
+        found(false)
+  {
+  }
+  IntMatrix &b;
+  double radius;
+  const vector<double> &pruning;
+  int max_trials, prec;
+  std::atomic<int> next_trial;
+  std::atomic<bool> found;  // stop flag of the enumerations
+  std::mutex mutex;         // protects RandGen, LDConvHelper, sol_coord and stats
+  IntVect sol_coord;
+  ExtremePruningStats stats;
+};
+
+/* Worker thread of shortest_vector_extreme_pruning(): runs trials until one of them succeeds.
+   The copy of b is u_lll * u_rand * b, where u_rand is the rerandomization and u_lll the
+   transformation of LLL. */
+static void extreme_pruning_trials(ExtremePruningState &state)
+{
+  Float::set_prec(state.prec);
+  int d = state.b.get_rows();
+  IntMatrix empty_mat;
+  IntVect x, lll_coord;
+
+  while (!state.found.load() && state.next_trial++ < state.max_trials)
+  {
+    IntMatrix b = state.b, u_rand, u_lll;
+    u_rand.gen_identity(d);
+    u_lll.gen_identity(d);
+    MatGSO<Integer, Float> rand_gso(b, u_rand, empty_mat, GSO_DEFAULT);
+    rand_gso.update_gso();
+    {
+      std::lock_guard<std::mutex> lock(state.mutex);
+      rerandomize_block(rand_gso, 0, d, BKZ_DEF_RERANDOMIZATION_DENSITY);
+    }
+
+    /* The dpe LLL runs without the lock, unlike the wrapper whose long double LLL converts
+       through the shared temporary of LDConvHelper. Its destructor frees this temporary, hence
+       it is destroyed under the lock. */
+    IntMatrix b_rand = b;
+    MatGSO<Integer, FP_NR<dpe_t>> lll_gso(b, u_lll, empty_mat, GSO_DEFAULT);
+    std::unique_ptr<LLLReduction<Integer, FP_NR<dpe_t>>> lll_obj(
+        new LLLReduction<Integer, FP_NR<dpe_t>>(lll_gso, LLL_DEF_DELTA, LLL_DEF_ETA, LLL_DEFAULT));
+    bool reduced = lll_obj->lll();
+    {
+      std::lock_guard<std::mutex> lock(state.mutex);
+      lll_obj.reset();
+      if (!reduced)
+      {
+        // not enough precision, the wrapper picks a larger one
+        b = b_rand;
+        u_lll.gen_identity(d);
+        lll_reduction(b, u_lll);
+      }
+    }
+
+    // the first solution stops the enumeration
+    MatGSO<Integer, Float> gso(b, empty_mat, empty_mat, GSO_INT_GRAM);
+    gso.update_gso();
+    PooledEvaluator<Float> evaluator(1, EVALSTRATEGY_FIRST_N_SOLUTIONS);
+    Enumeration<Float> enumobj(gso, evaluator);
+    enumobj.set_stop_flag(&state.found);
+    Float max_dist;
+    max_dist = state.radius;
+    enumobj.enumerate(0, d, max_dist, 0, vector<Float>(), vector<enumxt>(), state.pruning);
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.stats.nodes += enumobj.get_nodes();
+    if (evaluator.empty())
+    {
+      // after another success, this enumeration may have been stopped
+      if (state.found)
+        ++state.stats.stopped;
+      else
+        ++state.stats.trials;
+      continue;
+    }
+    ++state.stats.trials;
+    ++state.stats.successes;
+    if (state.found)
+      continue;
+    x.resize(d);
+    for (int i = 0; i < d; i++)
+      x[i].set_f(evaluator.begin()->second[i]);
+    vector_matrix_product(lll_coord, x, u_lll);
+    vector_matrix_product(state.sol_coord, lll_coord, u_rand);
+    state.found = true;
+  }
+}
+
+int shortest_vector_extreme_pruning(IntMatrix &b, IntVect &sol_coord, double radius,
+                                    const vector<double> &pruning, int max_trials,
+                                    unsigned int threads, ExtremePruningStats *stats, int flags)
+{
+  int d = b.get_rows(), n = b.get_cols();
+  FPLLL_CHECK(d > 0 && n > 0, "shortestVector: empty matrix");
+  FPLLL_CHECK(d <= n, "shortestVector: number of vectors > size of the vectors");
+  FPLLL_CHECK(pruning.empty() || static_cast<int>(pruning.size()) == d,
+              "shortestVector: pruning coefficients of the wrong dimension");
+
+  // Same precision as shortest_vector()
+  double rho;
+  int min_prec = gso_min_prec(rho, d, LLL_DEF_DELTA, LLL_DEF_ETA);
+  int prec     = max(53, min_prec + 10);
+
+  ExtremePruningState state(b, radius, pruning, max_trials, prec);
+  state.stats.trials      = 0;
+  state.stats.successes   = 0;
+  state.stats.stopped     = 0;
+  state.stats.probability = pruning.empty() ? 1.0 : svp_probability<FP_NR<double>>(pruning).get_d();
+  state.stats.nodes       = 0;
+
+  int old_prec = Float::set_prec(prec);
+  vector<std::thread> workers;
+  for (int i = 1; i < min(static_cast<int>(threads), max_trials); ++i)
+    workers.emplace_back(extreme_pruning_trials, std::ref(state));
+  extreme_pruning_trials(state);
+  for (auto &worker : workers)
+    worker.join();
+  Float::set_prec(old_prec);
+
+  if (flags & SVP_VERBOSE)
+  {
+    cout << "extreme pruning: " << state.stats.successes << " successes in "
+         << state.stats.trials << " trials (" << state.stats.stopped
+         << " stopped), predicted probability " << state.stats.probability << ", "
+         << state.stats.nodes << " nodes" << endl;
+  }
+  if (stats != nullptr)
+    *stats = state.stats;
+  if (!state.found)
+    return RED_ENUM_FAILURE;
+  sol_coord.swap(state.sol_coord);
+  return RED_SUCCESS;
+}
+
 /* Closest vector problem
    ====================== */
 
-static void get_gscoords(const Matrix<Float> &matrix, const Matrix<Float> &mu,
-                         const Matrix<Float> &r, const FloatVect &v, FloatVect &vcoord)
+static void get_gscoords(const Matrix<Float> &matrix, const TriangularMatrix<Float> &mu,
+                         const TriangularMatrix<Float> &r, const FloatVect &v, FloatVect &vcoord)
 {
 
   int n = matrix.get_rows(), m = matrix.get_cols();
@@ -313,8 +487,9 @@ static void get_gscoords(const Matrix<Float> &matrix, const Matrix<Float> &mu,
   }
 }
 
-static void babai(const FloatMatrix &matrix, const Matrix<Float> &mu, const Matrix<Float> &r,
-                  const FloatVect &target, FloatVect &target_coord)
+static void babai(const FloatMatrix &matrix, const TriangularMatrix<Float> &mu,
+                  const TriangularMatrix<Float> &r, const FloatVect &target,
+                  FloatVect &target_coord)
 {
 
   int d = matrix.get_rows();
@@ -327,8 +502,75 @@ static void babai(const FloatMatrix &matrix, const Matrix<Float> &mu, const Matr
   }
 }
 
+/* Subtracts from int_target the vectors found by Babai's algorithm and adds their coordinates to
+   sol_coord. Because we use fp, it might be necessary to do it several times (if
+   ||target|| >> ||b_i||): it stops when all the coordinates of Babai's vector are in [-1, 1].
+   target is set to int_target in fp and babai_sol to the coordinates of that last vector. */
+static void reduce_babai(const IntMatrix &b, const FloatMatrix &float_matrix,
+                         const TriangularMatrix<Float> &mu, const TriangularMatrix<Float> &r,
+                         IntVect &int_target, IntVect &sol_coord, FloatVect &target,
+                         FloatVect &babai_sol)
+{
+  int d = b.get_rows(), n = b.get_cols();
+  Integer itmp1;
+
+  for (int loop_idx = 0;; loop_idx++)
+  {
+    if (loop_idx >= 0x100 && ((loop_idx & (loop_idx - 1)) == 0))
+      FPLLL_INFO("warning: possible infinite loop in Babai's algorithm");
+
+    for (int i = 0; i < n; i++)
+    {
+      target[i].set_z(int_target[i]);
+    }
+    babai(float_matrix, mu, r, target, babai_sol);
+    int idx;
+    for (idx = 0; idx < d && babai_sol[idx] >= -1 && babai_sol[idx] <= 1; idx++)
+    {
+    }
+    if (idx == d)
+      break;
+
+    for (int i = 0; i < d; i++)
+    {
+      itmp1.set_f(babai_sol[i]);
+      sol_coord[i].add(sol_coord[i], itmp1);
+      for (int j = 0; j < n; j++)
+        int_target[j].submul(itmp1, b(i, j));
+    }
+  }
+}
+
+/* For exact CVP, the enumeration is reset below the depth with maximal r_i (see Enumeration). */
+static vector<int> get_max_indices(MatGSO<Integer, Float> &gso, int d)
+{
+  vector<int> max_indices(d);
+  int cur, max_index, previous_max_index;
+  previous_max_index = max_index = d - 1;
+  Float max_val;
+
+  while (max_index > 0)
+  {
+    max_val = gso.get_r_exp(max_index, max_index);
+    for (cur = previous_max_index - 1; cur >= 0; --cur)
+    {
+      if (max_val <= gso.get_r_exp(cur, cur))
+      {
+        max_val   = gso.get_r_exp(cur, cur);
+        max_index = cur;
+      }
+    }
+    for (cur                        = max_index; cur < previous_max_index; ++cur)
+      max_indices[cur]              = max_index;
+    max_indices[previous_max_index] = previous_max_index;
+    previous_max_index              = max_index;
+    --max_index;
+  }
+  return max_indices;
+}
+
 int closest_vector(IntMatrix &b, const IntVect &int_target, IntVect &sol_coord, int method,
-                   int flags)
+                   int flags, unsigned int threads)
 {
   // d = lattice dimension (note that it might decrease during preprocessing)
   int d = b.get_rows();
@@ -356,8 +598,7 @@ int closest_vector(IntMatrix &b, const IntVect &int_target, IntVect &sol_coord,
   gso.update_gso();
   gen_zero_vect(sol_coord, d);
 
-  /* Applies Babai's algorithm. Because we use fp, it might be necessary to
-      do it several times (if ||target|| >> ||b_i||) */
+  /* Applies Babai's algorithm (see reduce_babai()) */
   FloatMatrix float_matrix(d, n);
   FloatVect target(n), babai_sol;
   IntVect int_new_target = int_target;
@@ -366,33 +607,11 @@ int closest_vector(IntMatrix &b, const IntVect &int_target, IntVect &sol_coord,
     for (int j = 0; j < n; j++)
       float_matrix(i, j).set_z(b(i, j));
 
-  for (int loop_idx = 0;; loop_idx++)
-  {
-    if (loop_idx >= 0x100 && ((loop_idx & (loop_idx - 1)) == 0))
-      FPLLL_INFO("warning: possible infinite loop in Babai's algorithm");
-
-    for (int i = 0; i < n; i++)
-    {
-      target[i].set_z(int_new_target[i]);
-    }
-    babai(float_matrix, gso.get_mu_matrix(), gso.get_r_matrix(), target, babai_sol);
-    int idx;
-    for (idx = 0; idx < d && babai_sol[idx] >= -1 && babai_sol[idx] <= 1; idx++)
-    {
-    }
-    if (idx == d)
-      break;
-
-    for (int i = 0; i < d; i++)
-    {
-      itmp1.set_f(babai_sol[i]);
-      sol_coord[i].add(sol_coord[i], itmp1);
-      for (int j = 0; j < n; j++)
-        int_new_target[j].submul(itmp1, b(i, j));
-    }
-  }
+  const TriangularMatrix<Float> &mu = gso.get_mu_matrix();
+  const TriangularMatrix<Float> &r  = gso.get_r_matrix();
+  reduce_babai(b, float_matrix, mu, r, int_new_target, sol_coord, target, babai_sol);
   // FPLLL_TRACE("BabaiSol=" << sol_coord);
-  get_gscoords(float_matrix, gso.get_mu_matrix(), gso.get_r_matrix(), target, target_coord);
+  get_gscoords(float_matrix, mu, r, target, target_coord);
 
   /* Computes a very large bound to make the algorithm work
       until the first solution is found */
@@ -407,35 +626,15 @@ int closest_vector(IntMatrix &b, const IntVect &int_target, IntVect &sol_coord,
   if (method & CVPM_PROVED)
   {
     // For Exact CVP, we need to reset enum below depth with maximal r_i
-    max_indices = vector<int>(d);
-    int cur, max_index, previous_max_index;
-    previous_max_index = max_index = d - 1;
-    Float max_val;
-
-    while (max_index > 0)
-    {
-      max_val = gso.get_r_exp(max_index, max_index);
-      for (cur = previous_max_index - 1; cur >= 0; --cur)
-      {
-        if (max_val <= gso.get_r_exp(cur, cur))
-        {
-          max_val   = gso.get_r_exp(cur, cur);
-          max_index = cur;
-        }
-      }
-      for (cur                        = max_index; cur < previous_max_index; ++cur)
-        max_indices[cur]              = max_index;
-      max_indices[previous_max_index] = previous_max_index;
-      previous_max_index              = max_index;
-      --max_index;
-    }
+    max_indices = get_max_indices(gso, d);
   }
   FPLLL_TRACE("max_indices " << max_indices);
 
-  FastErrorBoundedEvaluator evaluator(n, gso.get_mu_matrix(), gso.get_r_matrix(), EVALMODE_CV);
+  FastErrorBoundedEvaluator evaluator(n, mu, r, EVALMODE_CV);
 
   // Main loop of the enumeration
   Enumeration<Float> enumobj(gso, evaluator, max_indices);
+  enumobj.set_threads(threads);
   enumobj.enumerate(0, d, max_dist, 0, target_coord);
 
   int result = RED_ENUM_FAILURE;
@@ -456,4 +655,330 @@ int closest_vector(IntMatrix &b, const IntVect &int_target, IntVect &sol_coord,
   return result;
 }
 
+/* Babai's algorithm in double on CVP_BABAI_LANES targets at once. The targets are the columns of
+   the n x CVP_BABAI_LANES matrix t, stored by rows so that the j-th coordinates of the targets are
+   contiguous. On return, x holds the coordinates of Babai's vectors and c the Gram-Schmidt
+   coordinates of the differences between the targets and Babai's vectors, in the same layout.
+   b, mu and r are the basis, mu and the diagonal of r in double, b and mu stored by rows.
+   The loops on the targets have a constant trip count, so that the compiler vectorizes them. */
+static void babai_lanes(const double *b, const double *mu, const double *r, int d, int n,
+                        const double *t, double *c, double *x)
+{
+  const int lanes = CVP_BABAI_LANES;
+
+  // Gram-Schmidt coordinates of the targets, as get_gscoords()
+  for (int i = 0; i < d; i++)
+  {
+    double *ci = c + i * lanes;
+    for (int k = 0; k < lanes; k++)
+      ci[k] = 0.0;
+    for (int j = 0; j < n; j++)
+    {
+      const double bij = b[i * n + j];
+      const double *tj = t + j * lanes;
+      for (int k = 0; k < lanes; k++)
+        ci[k] += bij * tj[k];
+    }
+    for (int j = 0; j < i; j++)
+    {
+      const double muij = mu[i * d + j];
+      const double *cj  = c + j * lanes;
+      for (int k = 0; k < lanes; k++)
+        ci[k] -= muij * cj[k];
+    }
+  }
+  for (int i = 0; i < d; i++)
+  {
+    for (int k = 0; k < lanes; k++)
+      c[i * lanes + k] /= r[i];
+  }
+
+  // Back-substitution, as babai()
+  for (int i = d - 1; i >= 0; i--)
+  {
+    double *ci = c + i * lanes, *xi = x + i * lanes;
+    for (int k = 0; k < lanes; k++)
+    {
+      xi[k] = rint(ci[k]);
+      ci[k] -= xi[k];
+    }
+    for (int j = 0; j < i; j++)
+    {
+      const double muij = mu[i * d + j];
+      double *cj        = c + j * lanes;
+      for (int k = 0; k < lanes; k++)
+        cj[k] -= muij * xi[k];
+    }
+  }
+}
+
+CVPSolver::CVPSolver(IntMatrix &b, int method, int flags)
+    : _b(b), d(b.get_rows()), n(b.get_cols()), _flags(flags), _threads(1), enumerated(0)
+{
+  FPLLL_CHECK(d > 0 && n > 0, "CVPSolver: empty matrix");
+  FPLLL_CHECK(d <= n, "CVPSolver: number of vectors > size of the vectors");
+
+  // Same precision as closest_vector()
+  double rho;
+  int min_prec = gso_min_prec(rho, d, LLL_DEF_DELTA, LLL_DEF_ETA);
+  prec         = max(53, min_prec + 10);
+  int old_prec = Float::set_prec(prec);
+
+  gso.reset(new MatGSO<Integer, Float>(b, empty_mat, empty_mat, GSO_INT_GRAM));
+  gso->update_gso();
+  gso_mu = &gso->get_mu_matrix();
+  gso_r  = &gso->get_r_matrix();
+  batch.reset(new BatchEnumeration<Float>(*gso));
+  gso_data.first = 0;
+  gso_data.last  = d;
+  batch->convert_gso(gso_data);
+
+  float_matrix.resize(d, n);
+  for (int i = 0; i < d; i++)
+    for (int j = 0; j < n; j++)
+      float_matrix(i, j).set_z(b(i, j));
+
+  if (method & CVPM_PROVED)
+    max_indices = get_max_indices(*gso, d);
+
+  /* Any non-zero vector of the lattice has a norm >= min(||b_i*||), so a vector at distance less
+     than half of it of the target is the closest one. The margin covers the errors on r. */
+  const TriangularMatrix<Float> &mu = *gso_mu;
+  const TriangularMatrix<Float> &r  = *gso_r;
+  babai_bound                       = r(0, 0);
+  for (int i = 1; i < d; i++)
+  {
+    if (r(i, i) < babai_bound)
+      babai_bound = r(i, i);
+  }
+  babai_bound.mul_d(babai_bound, 0.99 / 4);
+
+  /* Babai's algorithm in double, if the basis is exact in double. The error on the Gram-Schmidt
+     coordinates of a target t is heuristically less than
+     2^-53 (n + d) max|t_j| max_i(sum_j |b_ij| / r_ii). The targets are reduced in double if this
+     error is small compared to 1 (the rounding of Babai's algorithm) and if the error on the
+     distance to Babai's vector, at most this error times sum(r_ii), is small compared to the
+     margin of babai_bound. Other targets are reduced in Float by reduce_target(). */
+  basis_d.resize(d * n);
+  mu_d.resize(d * d);
+  r_d.resize(d);
+  double_babai = true;
+  double scale = 0.0, sum_r = 0.0;
+  for (int i = 0; i < d; i++)
+  {
+    double row_norm = 0.0;
+    for (int j = 0; j < n; j++)
+    {
+      basis_d[i * n + j] = b(i, j).get_d();
+      row_norm += fabs(basis_d[i * n + j]);
+    }
+    for (int j = 0; j < i; j++)
+      mu_d[i * d + j] = mu(i, j).get_d();
+    r_d[i] = r(i, i).get_d();
+    double_babai &= row_norm < ldexp(1.0, 53) && std::isnormal(r_d[i]) && r_d[i] > 0.0;
+    scale = max(scale, row_norm / r_d[i]);
+    sum_r += r_d[i];
+  }
+  babai_bound_d    = babai_bound.get_d();
+  double tolerance = min(ldexp(1.0, -20), ldexp(babai_bound_d / sum_r, -10));
+  max_babai_target = min(ldexp(1.0, 50), tolerance / (ldexp(n + d, -53) * scale));
+  double_babai &= std::isfinite(sum_r) && max_babai_target >= 1.0;
+
+  Float::set_prec(old_prec);
+}
+
+void CVPSolver::set_threads(unsigned int threads)
+{
+  _threads = max(threads, 1u);
+  batch->set_threads(_threads);
+}
+
+int CVPSolver::solve(const IntVect &target, IntVect &sol_coord)
+{
+  vector<IntVect> sol_coords;
+  vector<int> status;
+  solve(vector<IntVect>(1, target), sol_coords, status);
+  sol_coord.swap(sol_coords[0]);
+  return status[0];
+}
+
+void CVPSolver::solve(const vector<IntVect> &targets, vector<IntVect> &sol_coords,
+                      vector<int> &status)
+{
+  for (const IntVect &target : targets)
+    FPLLL_CHECK(static_cast<int>(target.size()) == n, "CVPSolver: target of the wrong dimension");
+
+  int old_prec = Float::set_prec(prec);
+  sol_coords.resize(targets.size());
+  status.assign(targets.size(), RED_SUCCESS);
+
+  // Babai's algorithm on each target
+  vector<std::unique_ptr<EnumerationJob<Float>>> target_jobs(targets.size());
+  std::atomic<size_t> next_target(0);
+  vector<std::thread> threads;
+  for (unsigned int i = 1; i < min<size_t>(_threads, targets.size()); ++i)
+    threads.emplace_back(&CVPSolver::reduce_targets, this, std::cref(targets),
+                         std::ref(sol_coords), std::ref(target_jobs), std::ref(next_target));
+  reduce_targets(targets, sol_coords, target_jobs, next_target);
+  for (auto &thread : threads)
+    thread.join();
+
+  // Enumeration of the targets which are not solved by Babai's vector
+  vector<EnumerationJob<Float>> jobs;
+  for (const auto &job : target_jobs)
+  {
+    if (job)
+      jobs.push_back(*job);
+  }
+  enumerated = jobs.size();
+  batch->enumerate(gso_data, jobs);
+
+  Integer itmp1;
+  for (size_t i = 0, k = 0; i < targets.size(); i++)
+  {
+    if (!target_jobs[i])
+      continue;
+    const EnumerationJob<Float> &job = jobs[k++];
+    // if no vector is found, Babai's vector is the closest one up to fp errors
+    if (job.evaluator.empty())
+      continue;
+    if (_flags & CVP_VERBOSE)
+      FPLLL_INFO("max_dist=" << job.maxdist);
+    for (int j = 0; j < d; j++)
+    {
+      itmp1.set_f(job.evaluator.begin()->second[j]);
+      sol_coords[i][j].add(sol_coords[i][j], itmp1);
+    }
+  }
+
+  Float::set_prec(old_prec);
+}
+
+/* Worker thread of solve(): reduces the targets which are not taken yet by another thread. */
+void CVPSolver::reduce_targets(const vector<IntVect> &targets, vector<IntVect> &sol_coords,
+                               vector<std::unique_ptr<EnumerationJob<Float>>> &jobs,
+                               std::atomic<size_t> &next_target)
+{
+  Float::set_prec(prec);
+  const size_t group = double_babai ? CVP_BABAI_LANES : 1;
+  vector<double> lanes(double_babai ? (n + 2 * d) * CVP_BABAI_LANES : 0);
+  for (size_t i = next_target.fetch_add(group); i < targets.size();
+       i = next_target.fetch_add(group))
+  {
+    if (double_babai)
+      reduce_lanes(targets, i, min(i + group, targets.size()), sol_coords, jobs, lanes);
+    else
+      reduce_target(targets[i], sol_coords[i], jobs[i]);
+  }
+}
+
+/* Reduces targets[first..last-1] as reduce_target(), with Babai's algorithm in double (see
+   babai_lanes()). The targets with a coordinate larger than max_babai_target are reduced by
+   reduce_target(). lanes is the storage of t, c and x of babai_lanes(). */
+void CVPSolver::reduce_lanes(const vector<IntVect> &targets, size_t first, size_t last,
+                             vector<IntVect> &sol_coords,
+                             vector<std::unique_ptr<EnumerationJob<Float>>> &jobs,
+                             vector<double> &lanes)
+{
+  const int num_lanes = CVP_BABAI_LANES;
+  double *t = &lanes[0], *c = t + n * num_lanes, *x = c + d * num_lanes;
+  size_t lane_targets[CVP_BABAI_LANES];
+  int used_lanes = 0;
+
+  for (size_t i = first; i < last; i++)
+  {
+    int j;
+    for (j = 0; j < n; j++)
+    {
+      double coord = targets[i][j].get_d();
+      if (!(fabs(coord) <= max_babai_target))
+        break;
+      t[j * num_lanes + used_lanes] = coord;
+    }
+    if (j < n)
+      reduce_target(targets[i], sol_coords[i], jobs[i]);
+    else
+      lane_targets[used_lanes++] = i;
+  }
+  if (used_lanes == 0)
+    return;
+  for (int k = used_lanes; k < num_lanes; k++)
+  {
+    for (int j = 0; j < n; j++)
+      t[j * num_lanes + k] = 0.0;
+  }
+
+  babai_lanes(&basis_d[0], &mu_d[0], &r_d[0], d, n, t, c, x);
+
+  FP_NR<double> coord;
+  Float dist;
+  for (int k = 0; k < used_lanes; k++)
+  {
+    size_t i           = lane_targets[k];
+    double dist_d      = 0.0;
+    IntVect &sol_coord = sol_coords[i];
+    sol_coord.resize(d);
+    for (int l = 0; l < d; l++)
+    {
+      coord = x[l * num_lanes + k];
+      sol_coord[l].set_f(coord);
+      dist_d += c[l * num_lanes + k] * c[l * num_lanes + k] * r_d[l];
+    }
+
+    jobs[i].reset();
+    if (dist_d < babai_bound_d)
+      continue;
+    dist = dist_d;
+    jobs[i].reset(new EnumerationJob<Float>(0, d, dist));
+    jobs[i]->target.resize(d);
+    for (int l = 0; l < d; l++)
+      jobs[i]->target[l] = c[l * num_lanes + k];
+    jobs[i]->max_indices = max_indices;
+  }
+}
+
+/* Reduces target with Babai's algorithm, sol_coord is set to the coordinates of Babai's vector. If
+   it is not proved to be the closest vector, job is set to the enumeration of the closest vector
+   to their difference, with the distance of Babai's vector as radius. */
+void CVPSolver::reduce_target(const IntVect &target, IntVect &sol_coord,
+                              std::unique_ptr<EnumerationJob<Float>> &job)
+{
+  const TriangularMatrix<Float> &mu = *gso_mu;
+  const TriangularMatrix<Float> &r  = *gso_r;
+  IntVect int_target                = target;
+  FloatVect float_target(n), babai_sol, target_coord;
+  Integer itmp1;
+
+  gen_zero_vect(sol_coord, d);
+  reduce_babai(_b, float_matrix, mu, r, int_target, sol_coord, float_target, babai_sol);
+  for (int i = 0; i < d; i++)
+  {
+    itmp1.set_f(babai_sol[i]);
+    sol_coord[i].add(sol_coord[i], itmp1);
+    for (int j = 0; j < n; j++)
+      int_target[j].submul(itmp1, _b(i, j));
+  }
+  for (int j = 0; j < n; j++)
+    float_target[j].set_z(int_target[j]);
+  get_gscoords(float_matrix, mu, r, float_target, target_coord);
+
+  // squared distance of Babai's vector to the projection of the target on the lattice
+  Float dist, ftmp;
+  dist = 0.0;
+  for (int i = 0; i < d; i++)
+  {
+    ftmp.mul(target_coord[i], target_coord[i]);
+    dist.addmul(ftmp, r(i, i));
+  }
+
+  job.reset();
+  if (dist < babai_bound)
+    return;
+  job.reset(new EnumerationJob<Float>(0, d, dist));
+  job->target.resize(d);
+  for (int i = 0; i < d; i++)
+    job->target[i] = target_coord[i].get_d();
+  job->max_indices = max_indices;
+}
+
 FPLLL_END_NAMESPACE
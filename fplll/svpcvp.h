@@ -18,6 +18,7 @@
 #ifndef FPLLL_SVPCVP_H
 #define FPLLL_SVPCVP_H
 
+#include "enum/enumerate.h"
 #include "util.h"
 
 FPLLL_BEGIN_NAMESPACE
@@ -26,7 +27,9 @@ FPLLL_BEGIN_NAMESPACE
  * Computes a shortest vector of a lattice.
  * The vectors must be linearly independant and the basis must be LLL-reduced
  * with delta=LLL_DEF_DELTA and eta=LLL_DEF_ETA.
- * The result is guaranteed if method = SVPM_PROVED.
+ * The result is guaranteed if method = SVPM_PROVED. With SVP_BATCH_VERIFY in flags, the exact
+ * norms of the candidate solutions are then computed in batches by a separate thread while the
+ * enumeration goes on (see ExactErrorBoundedEvaluator::set_batch()).
  */
 int shortest_vector(IntMatrix &b, IntVect &sol_coord, SVPMethod method = SVPM_PROVED,
                     int flags = SVP_DEFAULT);
@@ -41,14 +44,123 @@ int shortest_vector_pruning(IntMatrix &b, IntVect &sol_coord, vector<IntVect> &s
 int shortest_vector_pruning(IntMatrix &b, IntVect &sol_coord, vector<IntVect> &auxsol_coord,
                             vector<double> &auxsol_dist, const int max_aux_sols,
                             const vector<double> &pruning, int flags = SVP_DEFAULT);
+
+/**
+ * Same as shortest_vector() and shortest_vector_pruning() for long enumerations: the state of the
+ * enumeration is saved to checkpoint_file regularly (see EnumerationDyn::set_checkpoint()). With
+ * SVP_RESUME in flags, an enumeration of the same basis which was interrupted continues from the
+ * checkpoint. Enumerations with SVP_DUAL are not checkpointed.
+ */
+int shortest_vector(IntMatrix &b, IntVect &sol_coord, const string &checkpoint_file,
+                    SVPMethod method = SVPM_PROVED, int flags = SVP_DEFAULT);
+
+int shortest_vector_pruning(IntMatrix &b, IntVect &sol_coord, const vector<double> &pruning,
+                            const string &checkpoint_file, int flags = SVP_DEFAULT);
+
+/** Statistics of shortest_vector_extreme_pruning(). */
+struct ExtremePruningStats
+{
+  int trials;          // enumerations which ran to the end
+  int successes;       // enumerations which found a vector of squared norm <= radius
+  int stopped;         // enumerations stopped after another one succeeded
+  double probability;  // success probability of one enumeration given by svp_probability()
+  uint64_t nodes;      // nodes visited by all the enumerations
+};
+
+/**
+ * Extreme pruning: finds a vector of L(b) of squared norm at most radius with the enumeration
+ * pruned by `pruning` (see shortest_vector_pruning()), repeated on rerandomized and LLL-reduced
+ * copies of b until it succeeds. At most max_trials copies are enumerated, `threads` of them
+ * concurrently. As soon as one enumeration finds a vector, the others are stopped.
+ * Returns RED_SUCCESS and the coordinates of the vector in b, or RED_ENUM_FAILURE if no trial
+ * succeeded. The ratio of stats->successes to stats->trials is an estimate of the success
+ * probability of the pruning, to be compared with stats->probability.
+ */
+int shortest_vector_extreme_pruning(IntMatrix &b, IntVect &sol_coord, double radius,
+                                    const vector<double> &pruning, int max_trials,
+                                    unsigned int threads = 1, ExtremePruningStats *stats = nullptr,
+                                    int flags = SVP_DEFAULT);
+
 /**
  * Computes a closest vector of a lattice to a target.
  * The vectors must be linearly independant and the basis must be LLL-reduced
  * with delta=LLL_DEF_DELTA and eta=LLL_DEF_ETA.
  * The result is guaranteed if method = CVPM_PROVED.
+ * With CVPM_PROVED, the enumeration runs on `threads` threads (see EnumerationDyn::set_threads()).
  */
 int closest_vector(IntMatrix &b, const IntVect &int_target, vector<Integer> &sol_coord,
-                   int method = CVPM_FAST, int flags = CVP_DEFAULT);
+                   int method = CVPM_FAST, int flags = CVP_DEFAULT, unsigned int threads = 1);
+
+/* Number of targets reduced together by Babai's algorithm in double of CVPSolver */
+const int CVP_BABAI_LANES = 8;
+
+/**
+ * Closest vectors of many targets in the same lattice.
+ * The GSO of the basis is computed and converted for the enumeration once, by the constructor. The
+ * basis must satisfy the conditions of closest_vector() and must not be modified while the solver
+ * is used.
+ *
+ * Each target is first reduced with Babai's nearest plane algorithm. If Babai's vector is at
+ * distance less than min(||b_i*||) / 2 of the target, it is the closest vector and the target is
+ * not enumerated. Otherwise, the enumeration starts from the distance of Babai's vector.
+ *
+ * When the basis fits in double, Babai's algorithm runs in double on groups of CVP_BABAI_LANES
+ * targets at once. The targets with coordinates too large for the precision of double are reduced
+ * with the floating-point type of closest_vector() instead.
+ */
+class CVPSolver
+{
+public:
+  CVPSolver(IntMatrix &b, int method = CVPM_FAST, int flags = CVP_DEFAULT);
+
+  /** Same as closest_vector() with the basis of the solver. */
+  int solve(const IntVect &target, IntVect &sol_coord);
+
+  /**
+   * Solves a batch of targets: sol_coords[i] and status[i] are the results of solve() on
+   * targets[i]. The targets are reduced and enumerated concurrently on get_threads() threads.
+   */
+  void solve(const vector<IntVect> &targets, vector<IntVect> &sol_coords, vector<int> &status);
+
+  /** Number of threads of solve() on a batch, each target is solved by a single thread. */
+  void set_threads(unsigned int threads);
+  inline unsigned int get_threads() const { return _threads; }
+
+  /** Number of targets of the last call to solve() which were not solved by Babai's algorithm. */
+  inline size_t get_enumerated() const { return enumerated; }
+
+private:
+  IntMatrix &_b;
+  int d, n, prec, _flags;
+  unsigned int _threads;
+  size_t enumerated;
+
+  IntMatrix empty_mat;
+  std::unique_ptr<MatGSO<Integer, Float>> gso;
+  // mu and r of gso, fetched once by the constructor and only read afterwards, also by the threads
+  // of solve()
+  const TriangularMatrix<Float> *gso_mu, *gso_r;
+  std::unique_ptr<BatchEnumeration<Float>> batch;
+  EnumerationGSOData gso_data;
+  FloatMatrix float_matrix;
+  vector<int> max_indices;
+  Float babai_bound;  // bound on the squared distance to Babai's vector under which it is closest
+
+  // Babai's algorithm in double (see reduce_lanes()), used if double_babai is set
+  bool double_babai;
+  double max_babai_target;  // targets with larger coordinates are reduced in Float
+  double babai_bound_d;
+  vector<double> basis_d, mu_d, r_d;
+
+  void reduce_target(const IntVect &target, IntVect &sol_coord,
+                     std::unique_ptr<EnumerationJob<Float>> &job);
+  void reduce_lanes(const vector<IntVect> &targets, size_t first, size_t last,
+                    vector<IntVect> &sol_coords,
+                    vector<std::unique_ptr<EnumerationJob<Float>>> &jobs, vector<double> &lanes);
+  void reduce_targets(const vector<IntVect> &targets, vector<IntVect> &sol_coords,
+                      vector<std::unique_ptr<EnumerationJob<Float>>> &jobs,
+                      std::atomic<size_t> &next_target);
+};
 
 FPLLL_END_NAMESPACE
 
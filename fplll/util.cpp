@@ -130,7 +130,7 @@ void sphere_volume(Float &volume, int d)
 /**
  * Estimates the cost of the enumeration for SVP.
  */
-void cost_estimate(Float &cost, const Float &bound, const Matrix<Float> &r, int dimMax)
+void cost_estimate(Float &cost, const Float &bound, const TriangularMatrix<Float> &r, int dimMax)
 {
   Float det, level_cost, tmp1;
   det  = 1.0;
@@ -103,7 +103,7 @@ void sphere_volume(Float &volume, int d);
 /**
  * Estimates the cost of the enumeration for SVP.
  */
-void cost_estimate(Float &cost, const Float &bound, const Matrix<Float> &r, int dimMax);
+void cost_estimate(Float &cost, const Float &bound, const TriangularMatrix<Float> &r, int dimMax);
 
 template <class ZT> void zeros_first(ZZ_mat<ZT> &b, ZZ_mat<ZT> &u, ZZ_mat<ZT> &u_inv_t);
 
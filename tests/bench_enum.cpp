@@ -0,0 +1,248 @@
+/* Copyright (C) 2017 The fplll development team
+
+   This file is part of fplll. fplll is free software: you
+   can redistribute it and/or modify it under the terms of the GNU Lesser
+   General Public License as published by the Free Software Foundation,
+   either version 2.1 of the License, or (at your option) any later version.
+
+   fplll is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with fplll. If not, see <http://www.gnu.org/licenses/>. */
+
+/* Benchmark of the enumeration: SVP enumeration on fixed knapsack and q-ary bases, for several
+   dimensions and floating-point types, with and without pruning. The results are printed as JSON
+   on the standard output, so that the node rate can be compared between versions.
+
+   Usage: bench_enum [-min d] [-max d] [-max-unpruned d] [-step s] [-repeat r] [-threads t] */
+
+#include "io/json.hpp"
+#include <chrono>
+#include <cstring>
+#include <fplll.h>
+
+#ifdef FPLLL_WITH_QD
+#include <qd/dd_real.h>
+#endif
+
+using namespace std;
+using namespace fplll;
+using json = nlohmann::json;
+
+/* the bases only depend on the seed and the dimension */
+const unsigned long BENCH_SEED = 1;
+const int BENCH_BKZ_BLOCK_SIZE = 20;
+const double BENCH_GH_FACTOR   = 1.1;
+
+enum BenchBasis
+{
+  BASIS_KNAPSACK = 0,
+  BASIS_QARY     = 1
+};
+
+const char *const BENCH_BASIS_NAMES[] = {"knapsack", "qary"};
+
+/**
+   @brief Generate a basis of dimension `d` and reduce it with BKZ.
+
+   @param A              output basis
+   @param basis          type of the basis
+   @param d              dimension
+*/
+
+void gen_basis(ZZ_mat<mpz_t> &A, BenchBasis basis, int d)
+{
+  RandGen::init_with_seed(BENCH_SEED + d);
+  if (basis == BASIS_KNAPSACK)
+  {
+    A.resize(d, d + 1);
+    A.gen_intrel(10 * d);
+  }
+  else
+  {
+    A.resize(d, d);
+    A.gen_qary_prime(d / 2, 30);
+  }
+  bkz_reduction(A, BENCH_BKZ_BLOCK_SIZE);
+}
+
+/**
+   @brief Enumerate the shortest vector of `A` with the floating-point type FT.
+
+   The radius is `BENCH_GH_FACTOR` times the Gaussian heuristic (or the first vector if it is
+   shorter), the pruned enumeration uses linear pruning. The time is the fastest of `repeat` runs.
+   The nodes per level are counted by one more run with detailed statistics, whose kernel is not
+   the timed one, and given with the numbers predicted by the pruner.
+
+   @param result         configuration of the run, the measurements are added to it
+   @param A              reduced basis
+   @param pruned         use pruning
+   @param repeat         number of runs
+   @param threads        number of threads of the enumeration
+*/
+
+template <class FT>
+void bench_enum(json &result, ZZ_mat<mpz_t> &A, bool pruned, int repeat, unsigned int threads)
+{
+  int d = A.get_rows();
+  ZZ_mat<mpz_t> empty_mat;
+  MatGSO<Z_NR<mpz_t>, FT> gso(A, empty_mat, empty_mat, GSO_INT_GRAM);
+  gso.update_gso();
+
+  FT radius, root_det = gso.get_root_det(0, d);
+  gso.get_r(radius, 0, 0);
+  adjust_radius_to_gh_bound(radius, 0, d, root_det, BENCH_GH_FACTOR);
+  vector<enumf> pruning(d, 1.0);
+  if (pruned)
+    pruning = Pruning::LinearPruning(d, d - 3).coefficients;
+
+  FT r_ii;
+  vector<double> r(d), predicted_nodes;
+  for (int i = 0; i < d; ++i)
+  {
+    gso.get_r(r_ii, i, i);
+    r[i] = r_ii.get_d();
+  }
+  Pruner<FP_NR<double>> pruner(radius.get_d());
+  pruner.load_basis_shape(r);
+  pruner.single_enum_cost(pruning, &predicted_nodes);
+
+  double seconds = 0.0;
+  uint64_t nodes = 0;
+  for (int i = 0; i < repeat; ++i)
+  {
+    FT max_dist = radius;
+    PooledEvaluator<FT> evaluator;
+    Enumeration<FT> enumobj(gso, evaluator);
+    enumobj.set_threads(threads);
+    auto start = chrono::steady_clock::now();
+    enumobj.enumerate(0, d, max_dist, 0, vector<FT>(), vector<enumxt>(), pruning);
+    double run_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (i == 0 || run_seconds < seconds)
+      seconds = run_seconds;
+    nodes = enumobj.get_nodes();
+  }
+
+  FT max_dist = radius;
+  PooledEvaluator<FT> evaluator;
+  Enumeration<FT> enumobj(gso, evaluator);
+  enumobj.set_threads(threads);
+  enumobj.set_detailed_stats(true);
+  enumobj.enumerate(0, d, max_dist, 0, vector<FT>(), vector<enumxt>(), pruning);
+  const EnumerationStats &stats = enumobj.get_stats();
+
+  result["nodes"]            = nodes;
+  result["solutions"]        = stats.solutions;
+  result["seconds"]          = seconds;
+  result["nodes_per_second"] = seconds > 0.0 ? nodes / seconds : 0.0;
+  // level 0 is the last coordinate of the enumeration, level d - 1 the root of the tree
+  result["nodes_per_level"]           = stats.level_nodes;
+  result["predicted_nodes_per_level"] = predicted_nodes;
+}
+
+/**
+   @brief Run the benchmark on `A` for each floating-point type.
+*/
+
+void bench_float_types(json &results, json config, ZZ_mat<mpz_t> &A, bool pruned, int repeat,
+                       unsigned int threads)
+{
+  config["float_type"] = "double";
+  bench_enum<FP_NR<double>>(config, A, pruned, repeat, threads);
+  results.push_back(config);
+#ifdef FPLLL_WITH_LONG_DOUBLE
+  config["float_type"] = "long double";
+  bench_enum<FP_NR<long double>>(config, A, pruned, repeat, threads);
+  results.push_back(config);
+#endif
+#ifdef FPLLL_WITH_DPE
+  config["float_type"] = "dpe";
+  bench_enum<FP_NR<dpe_t>>(config, A, pruned, repeat, threads);
+  results.push_back(config);
+#endif
+#ifdef FPLLL_WITH_QD
+  config["float_type"] = "dd";
+  bench_enum<FP_NR<dd_real>>(config, A, pruned, repeat, threads);
+  results.push_back(config);
+  config["float_type"] = "qd";
+  bench_enum<FP_NR<qd_real>>(config, A, pruned, repeat, threads);
+  results.push_back(config);
+#endif
+  config["float_type"] = "mpfr";
+  bench_enum<FP_NR<mpfr_t>>(config, A, pruned, repeat, threads);
+  results.push_back(config);
+}
+
+/**
+   @brief Run the enumeration benchmark.
+
+   By default, dimensions 30 to 70 with pruning and 30 to 50 without.
+
+   @param argc             number of arguments
+   @param argv             options, see above
+   @return
+*/
+
+int main(int argc, char *argv[])
+{
+  int min_dim = 30, max_dim = 70, max_unpruned_dim = 50, step = 10, repeat = 1;
+  unsigned int threads = 1;
+
+  for (int i = 1; i < argc; i += 2)
+  {
+    int value = i + 1 < argc ? atoi(argv[i + 1]) : 0;
+    if (value <= 0)
+    {
+      cerr << "Usage: " << argv[0] << " [-min d] [-max d] [-max-unpruned d] [-step s]"
+           << " [-repeat r] [-threads t]" << endl;
+      return 1;
+    }
+    if (strcmp(argv[i], "-min") == 0)
+      min_dim = value;
+    else if (strcmp(argv[i], "-max") == 0)
+      max_dim = value;
+    else if (strcmp(argv[i], "-max-unpruned") == 0)
+      max_unpruned_dim = value;
+    else if (strcmp(argv[i], "-step") == 0)
+      step = value;
+    else if (strcmp(argv[i], "-repeat") == 0)
+      repeat = value;
+    else if (strcmp(argv[i], "-threads") == 0)
+      threads = value;
+    else
+    {
+      cerr << "Unknown option " << argv[i] << endl;
+      return 1;
+    }
+  }
+
+  json results = json::array();
+  for (int basis = BASIS_KNAPSACK; basis <= BASIS_QARY; ++basis)
+  {
+    for (int d = min_dim; d <= max_dim; d += step)
+    {
+      ZZ_mat<mpz_t> A;
+      gen_basis(A, BenchBasis(basis), d);
+      for (int pruned = 1; pruned >= 0; --pruned)
+      {
+        if (!pruned && d > max_unpruned_dim)
+          continue;
+        json config;
+        config["basis"]     = BENCH_BASIS_NAMES[basis];
+        config["dimension"] = d;
+        config["pruned"]    = pruned != 0;
+        config["threads"]   = threads;
+        bench_float_types(results, config, A, pruned, repeat, threads);
+      }
+    }
+  }
+
+  json output;
+  output["seed"]    = BENCH_SEED;
+  output["results"] = results;
+  cout << output.dump(2) << endl;
+  return 0;
+}
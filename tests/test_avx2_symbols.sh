@@ -0,0 +1,39 @@
+#!/bin/sh
+# Check that the AVX2 enumeration kernel does not define any symbol which is
+# also defined by the rest of the library. The linker keeps a single copy of
+# such a (weak) symbol, so either the AVX2 kernel would call code compiled
+# without AVX2, or the generic code would run AVX2 instructions.
+
+TOPBUILDDIR=${TOPBUILDDIR:-../fplll}
+
+# libtool keeps the objects of the shared library in .libs
+objects() {
+  if ls "$1"/.libs/*.o > /dev/null 2>&1; then
+    ls "$1"/.libs/*.o
+  else
+    ls "$1"/*.o 2> /dev/null
+  fi
+}
+
+OBJECTS=`objects "$TOPBUILDDIR"; objects "$TOPBUILDDIR/enum"`
+AVX2_OBJECT=`echo "$OBJECTS" | grep libenumavx2_la-`
+if test -z "$AVX2_OBJECT"; then
+  echo "AVX2 enumeration kernel not built, skipping"
+  exit 77
+fi
+
+defined_symbols() {
+  nm --defined-only "$@" | awk '$2 ~ /^[TWVu]$/ { print $3 }' | sort -u
+}
+
+TMP=`mktemp -d` || exit 1
+trap 'rm -rf "$TMP"' 0
+defined_symbols $AVX2_OBJECT > "$TMP/avx2" || exit 1
+defined_symbols `echo "$OBJECTS" | grep -v libenumavx2_la-` > "$TMP/other" || exit 1
+
+comm -12 "$TMP/avx2" "$TMP/other" > "$TMP/shared"
+if test -s "$TMP/shared"; then
+  echo "symbols defined by both the AVX2 kernel and the rest of the library:"
+  c++filt < "$TMP/shared"
+  exit 1
+fi
@@ -64,11 +64,15 @@ int test_bkz(ZZ_mat<ZT> &A, const int block_size, FloatType float_type, int flag
 
    @param A                test matrix
    @param block_size       block size
+   @param flags            flags to use
+   @param threads          threads of the size reductions
 
    @return zero on success.
 */
 
-template <class ZT> int test_bkz_param(ZZ_mat<ZT> &A, const int block_size, int flags = BKZ_DEFAULT)
+template <class ZT>
+int test_bkz_param(ZZ_mat<ZT> &A, const int block_size, int flags = BKZ_DEFAULT,
+                   unsigned int threads = 1)
 {
 
   int status = 0;
@@ -93,7 +97,8 @@ template <class ZT> int test_bkz_param(ZZ_mat<ZT> &A, const int block_size, int
   }
 
   BKZParam params(block_size, strategies);
-  params.flags = flags;
+  params.flags   = flags;
+  params.threads = threads;
   // zero on success
   status = bkz_reduction(&A, NULL, params, FT_DEFAULT, 53);
   if (status != RED_SUCCESS)
@@ -211,13 +216,15 @@ template <class ZT>
 int test_int_rel(int d, int b, const int block_size, FloatType float_type = FT_DEFAULT,
                  int flags = BKZ_DEFAULT, int prec = 0)
 {
-  ZZ_mat<ZT> A, B;
+  ZZ_mat<ZT> A, B, C;
   A.resize(d, d + 1);
   A.gen_intrel(b);
   B          = A;
+  C          = A;
   int status = 0;
   status |= test_bkz<ZT>(A, block_size, float_type, flags | BKZ_VERBOSE, prec);
   status |= test_bkz_param<ZT>(B, block_size);
+  status |= test_bkz_param<ZT>(C, block_size, BKZ_DEFAULT, 4);
   status |= test_bkz_param_linear_pruning<ZT>(B, block_size);
   status |= test_bkz_param_pruning<ZT>(B, block_size);
   return status;
@@ -57,10 +57,13 @@ template <class ZT> void read_vector(vector<Z_NR<ZT>> &b, const char *input_file
 
    @param A              input lattice
    @param b              expected vector
+   @param threads        number of threads of the enumeration
    @return
 */
 
-template <class ZT> int test_cvp(ZZ_mat<ZT> &A, IntVect &target, IntVect &b, const int method)
+template <class ZT>
+int test_cvp(ZZ_mat<ZT> &A, IntVect &target, IntVect &b, const int method,
+             unsigned int threads = 1)
 {
   IntVect sol_coord;  // In the LLL-reduced basis
   IntVect solution;
@@ -75,7 +78,7 @@ template <class ZT> int test_cvp(ZZ_mat<ZT> &A, IntVect &target, IntVect &b, con
     return status;
   }
 
-  status = closest_vector(A, target, sol_coord, method);
+  status = closest_vector(A, target, sol_coord, method, CVP_DEFAULT, threads);
 
   if (status != RED_SUCCESS)
   {
@@ -99,6 +102,25 @@ template <class ZT> int test_cvp(ZZ_mat<ZT> &A, IntVect &target, IntVect &b, con
   if (!correct)
     return 1;
 
+  // same result with a solver of the reduced basis
+  CVPSolver solver(A, method);
+  status = solver.solve(target, sol_coord);
+  if (status != RED_SUCCESS)
+  {
+    cerr << "CVPSolver failure: " << get_red_status_str(status) << endl;
+    return status;
+  }
+  vector_matrix_product(solution, sol_coord, A);
+  for (int i = 0; i < A.get_cols(); i++)
+  {
+    correct = correct && (solution[i] == b[i]);
+  }
+  if (!correct)
+  {
+    cerr << "CVPSolver: wrong vector" << endl;
+    return 1;
+  }
+
   return 0;
 }
 
@@ -108,12 +130,14 @@ template <class ZT> int test_cvp(ZZ_mat<ZT> &A, IntVect &target, IntVect &b, con
    @param input_filename_lattice   filename of an input lattice
    @param input_filename_target    filename of a target vector
    @param output_filename  filename of the expected vector
+   @param threads          number of threads of the enumeration
    @return
 */
 
 template <class ZT>
 int test_filename(const char *input_filename_lattice, const char *input_filename_target,
-                  const char *output_filename, const int method = CVPM_FAST)
+                  const char *output_filename, const int method = CVPM_FAST,
+                  unsigned int threads = 1)
 {
   ZZ_mat<ZT> A;
   read_matrix(A, input_filename_lattice);
@@ -124,7 +148,133 @@ int test_filename(const char *input_filename_lattice, const char *input_filename
   IntVect b;
   read_vector(b, output_filename);
 
-  return test_cvp<ZT>(A, t, b, method);
+  return test_cvp<ZT>(A, t, b, method, threads);
+}
+
+/**
+   @brief Squared distance between the vector of coordinates `sol_coord` in `A` and `target`.
+*/
+
+Z_NR<mpz_t> cvp_dist(ZZ_mat<mpz_t> &A, const IntVect &target, const IntVect &sol_coord)
+{
+  IntVect solution;
+  Z_NR<mpz_t> dist, diff;
+  vector_matrix_product(solution, sol_coord, A);
+  dist = 0;
+  for (int i = 0; i < A.get_cols(); i++)
+  {
+    diff.sub(solution[i], target[i]);
+    dist.addmul(diff, diff);
+  }
+  return dist;
+}
+
+/**
+   @brief Test if the parallel CVP enumeration finds a vector as close as the serial one.
+
+   @param d                dimension of the q-ary lattice
+   @param threads          number of threads of the parallel enumeration
+   @return
+*/
+
+int test_threads(int d, unsigned int threads)
+{
+  ZZ_mat<mpz_t> A(d, d);
+  RandGen::init_with_seed(d);
+  A.gen_qary_prime(d / 2, 20);
+  lll_reduction(A);
+
+  IntVect target(d);
+  for (int i = 0; i < d; i++)
+    target[i] = 1000 * i * i + 337;
+
+  Z_NR<mpz_t> dist[2];
+  for (int i = 0; i < 2; i++)
+  {
+    IntVect sol_coord;
+    int status = closest_vector(A, target, sol_coord, CVPM_PROVED, CVP_DEFAULT, i ? threads : 1);
+    if (status != RED_SUCCESS)
+    {
+      cerr << "Failure: " << get_red_status_str(status) << endl;
+      return status;
+    }
+    dist[i] = cvp_dist(A, target, sol_coord);
+  }
+  if (dist[0] != dist[1])
+  {
+    cerr << "Parallel CVP: distance " << dist[1] << " instead of " << dist[0] << endl;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+   @brief Test if CVPSolver finds vectors as close as closest_vector on a batch of targets.
+
+   Half of the targets are lattice vectors plus a small error, which Babai's algorithm solves
+   without enumeration. Some of them are multiplied by 2^60, so that they are too large for
+   Babai's algorithm in double.
+
+   @param d                dimension of the q-ary lattice
+   @param method           CVPM_FAST or CVPM_PROVED
+   @param threads          number of threads of the solver
+   @return
+*/
+
+int test_solver(int d, int method, unsigned int threads)
+{
+  ZZ_mat<mpz_t> A(d, d);
+  RandGen::init_with_seed(d);
+  A.gen_qary_prime(d / 2, 20);
+  lll_reduction(A);
+
+  const int nr_targets = 40;
+  vector<IntVect> targets(nr_targets, IntVect(d));
+  for (int t = 0; t < nr_targets; t++)
+  {
+    for (int i = 0; i < d; i++)
+    {
+      if (t % 2)
+      {
+        targets[t][i] = (1000003L * (t + 1) * (i + 7)) % 1048576;
+      }
+      else
+      {
+        targets[t][i].add(A(t % d, i), A((t + 1) % d, i));
+        if (t % 4 == 2)
+          targets[t][i].mul_2si(targets[t][i], 60);
+        targets[t][i].add_ui(targets[t][i], (t + i) % 3);
+      }
+    }
+  }
+
+  CVPSolver solver(A, method);
+  solver.set_threads(threads);
+  vector<IntVect> sol_coords;
+  vector<int> status;
+  solver.solve(targets, sol_coords, status);
+  if (solver.get_enumerated() > nr_targets / 2)
+  {
+    cerr << "CVPSolver: " << solver.get_enumerated() << " targets enumerated" << endl;
+    return 1;
+  }
+
+  for (int t = 0; t < nr_targets; t++)
+  {
+    IntVect sol_coord;
+    if (status[t] != RED_SUCCESS || closest_vector(A, targets[t], sol_coord, method) != RED_SUCCESS)
+    {
+      cerr << "Failure on target " << t << endl;
+      return 1;
+    }
+    if (cvp_dist(A, targets[t], sol_coords[t]) != cvp_dist(A, targets[t], sol_coord))
+    {
+      cerr << "CVPSolver: distance " << cvp_dist(A, targets[t], sol_coords[t]) << " instead of "
+           << cvp_dist(A, targets[t], sol_coord) << " on target " << t << endl;
+      return 1;
+    }
+  }
+  return 0;
 }
 
 /**
@@ -154,6 +304,16 @@ int main(int argc, char *argv[])
   status |= test_filename<mpz_t>(TESTDATADIR "/tests/lattices/example_cvp_in_lattice5",
                                  TESTDATADIR "/tests/lattices/example_cvp_in_target5",
                                  TESTDATADIR "/tests/lattices/example_cvp_out5", CVPM_PROVED);
+  status |= test_filename<mpz_t>(TESTDATADIR "/tests/lattices/example_cvp_in_lattice4",
+                                 TESTDATADIR "/tests/lattices/example_cvp_in_target4",
+                                 TESTDATADIR "/tests/lattices/example_cvp_out4", CVPM_PROVED, 4);
+  status |= test_filename<mpz_t>(TESTDATADIR "/tests/lattices/example_cvp_in_lattice5",
+                                 TESTDATADIR "/tests/lattices/example_cvp_in_target5",
+                                 TESTDATADIR "/tests/lattices/example_cvp_out5", CVPM_PROVED, 4);
+  status |= test_threads(30, 4);
+  status |= test_threads(36, 3);
+  status |= test_solver(30, CVPM_FAST, 1);
+  status |= test_solver(30, CVPM_PROVED, 3);
 
   if (status == 0)
   {
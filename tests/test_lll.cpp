@@ -147,6 +147,57 @@ int test_int_rel(int d, int b, LLLMethod method, FloatType float_type = FT_DEFAU
   return test_lll<ZT>(A, method, float_type, flags, prec);
 }
 
+/**
+   @brief Test the parallel size reduction: an LLL reduced basis is scrambled by adding random
+   multiples of each row to the next ones, which keeps its GSO, and size reduced again.
+
+   @param d                dimension
+   @param b                bit size
+   @param threads          number of threads of the size reduction
+
+   @return zero on success
+*/
+
+int test_parallel_size_reduction(int d, int b, unsigned int threads)
+{
+  ZZ_mat<mpz_t> A(d, d + 1), U, UT;
+  A.gen_intrel(b);
+  int status = lll_reduction(A);
+  if (status != RED_SUCCESS)
+    return status;
+
+  Z_NR<mpz_t> x;
+  for (int i = d - 1; i > 0; i--)
+  {
+    for (int j = 0; j < i; j++)
+    {
+      x.randb(20);
+      A[i].addmul(A[j], x);
+    }
+  }
+
+  const int old_prec = FP_NR<mpfr_t>::set_prec(2 * b);
+  int result         = 0;
+  {
+    MatGSO<Z_NR<mpz_t>, FP_NR<mpfr_t>> M(A, U, UT, GSO_DEFAULT);
+    LLLReduction<Z_NR<mpz_t>, FP_NR<mpfr_t>> lll_obj(M, LLL_DEF_DELTA, LLL_DEF_ETA, LLL_DEFAULT);
+    lll_obj.set_threads(threads);
+    if (!lll_obj.size_reduction())
+    {
+      cerr << "Parallel size reduction failed with error '"
+           << get_red_status_str(lll_obj.status) << "'" << endl;
+      result = lll_obj.status;
+    }
+    else if (!is_lll_reduced<Z_NR<mpz_t>, FP_NR<mpfr_t>>(M, LLL_DEF_DELTA, LLL_DEF_ETA))
+    {
+      cerr << "Output of the parallel size reduction is not LLL reduced" << endl;
+      result = 1;
+    }
+  }
+  FP_NR<mpfr_t>::set_prec(old_prec);
+  return result;
+}
+
 int main(int /*argc*/, char ** /*argv*/)
 {
 
@@ -161,6 +212,8 @@ int main(int /*argc*/, char ** /*argv*/)
   status |= test_int_rel<mpz_t>(30, 2000, LM_PROVED, FT_DPE);
   status |= test_int_rel<mpz_t>(30, 2000, LM_PROVED, FT_MPFR);
 
+  status |= test_parallel_size_reduction(60, 400, 4);
+
   status |= test_filename<mpz_t>("lattices/example_in", LM_HEURISTIC);
   status |= test_filename<mpz_t>("lattices/example_in", LM_FAST, FT_DOUBLE);
   status |= test_filename<mpz_t>("lattices/example_in", LM_PROVED, FT_MPFR);
@@ -67,6 +67,123 @@ template <class FT> int test_root()
   return status;
 }
 
+/**
+   @brief Compare the row operations of a vector of machine integers with the ones on mpz.
+
+   @param n     length of the vectors
+   @return zero on success
+*/
+
+template <class ZT> int test_row_addmul_2exp(int n)
+{
+  NumVect<Z_NR<ZT>> a(n), b(n);
+  NumVect<Z_NR<mpz_t>> a_ref(n), b_ref(n);
+  Z_NR<ZT> tmp, x;
+  Z_NR<mpz_t> tmp_ref, x_ref;
+  for (int i = 0; i < n; i++)
+  {
+    a[i]     = i * 7 % 13 - 6;
+    a_ref[i] = i * 7 % 13 - 6;
+    b[i]     = i % 5 - 2;
+    b_ref[i] = i % 5 - 2;
+  }
+
+  int status = 0;
+  for (long expo = 0; expo < 20; expo += 3)
+  {
+    a.addmul_si_2exp(b, expo - 9, expo, n, tmp);
+    a_ref.addmul_si_2exp(b_ref, expo - 9, expo, n, tmp_ref);
+    x     = expo + 1;
+    x_ref = expo + 1;
+    a.addmul_2exp(b, x, expo, n, tmp);
+    a_ref.addmul_2exp(b_ref, x_ref, expo, n, tmp_ref);
+  }
+  for (int i = 0; i < n; i++)
+    status |= a[i].get_si() != a_ref[i].get_si();
+  return status;
+}
+
+/**
+   @brief Check that row permutations, resizing and transposition of a matrix keep its content.
+
+   @param rows  number of rows
+   @param cols  number of columns
+   @return zero on success
+*/
+
+template <class T> int test_matrix_rows(int rows, int cols)
+{
+  Matrix<T> m(rows, cols);
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++)
+      m(i, j) = 100 * i + j;
+
+  m.swap_rows(0, rows - 1);
+  m.rotate_left(1, rows - 1);
+  m.rotate_right(1, rows - 1);
+  m.rotate(0, 1, rows - 1);
+  m.rotate(0, rows - 1, rows - 1);
+  m.swap_rows(0, rows - 1);
+  m.resize(2 * rows, 2 * cols);
+  m.transpose();
+  m.transpose();
+
+  int status = 0;
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++)
+      status |= m(i, j) != 100 * i + j;
+  return status;
+}
+
+/**
+   @brief Compare the rotations of a lower triangular Gram matrix stored in a TriangularMatrix with
+   the ones of a Matrix.
+
+   @param n     dimension
+   @return zero on success
+*/
+
+int test_triangular_gram(int n)
+{
+  Matrix<Z_NR<long>> g(n, n);
+  TriangularMatrix<Z_NR<long>> t(n);
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j <= i; j++)
+    {
+      g(i, j) = 100 * i + j;
+      t(i, j) = 100 * i + j;
+    }
+
+  int status = 0;
+  g.rotate_gram_left(1, n - 2, n - 1);
+  t.rotate_gram_left(1, n - 2, n - 1);
+  g.rotate_gram_right(0, n - 3, n);
+  t.rotate_gram_right(0, n - 3, n);
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j <= i; j++)
+      status |= t[i][j] != g(i, j);
+
+  // only the columns 0, ..., 2 are moved with the rows
+  g.rotate_left(2, n - 1);
+  t.rotate_left(2, n - 1);
+  t.resize(2 * n);
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j <= min(i, 2); j++)
+      status |= t(i, j) != g(i, j);
+
+  // copied to a Matrix, with zeros above the diagonal
+  Matrix<Z_NR<long>> m;
+  t.to_matrix(m);
+  status |= m.get_rows() != 2 * n || m.get_cols() != 2 * n;
+  for (int i = 0; i < 2 * n; i++)
+  {
+    status |= t[i].size() != i + 1;
+    for (int j = 0; j < 2 * n; j++)
+      status |= j <= i ? m(i, j) != t(i, j) : m(i, j) != 0;
+  }
+  return status;
+}
+
 int main(int argc, char *argv[])
 {
 
@@ -112,6 +229,13 @@ int main(int argc, char *argv[])
 #endif
   status |= test_str<FP_NR<mpfr_t>>();
 
+  status |= test_row_addmul_2exp<long>(37);
+  status |= test_row_addmul_2exp<double>(37);
+
+  status |= test_matrix_rows<Z_NR<mpz_t>>(7, 5);
+  status |= test_matrix_rows<FP_NR<double>>(13, 17);
+  status |= test_triangular_gram(11);
+
   if (status == 0)
   {
     cerr << "All tests passed." << endl;
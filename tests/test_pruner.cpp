@@ -507,6 +507,60 @@ template <class FT> int test_auto_prune(size_t n)
   return status;
 }
 
+/**
+   @brief Compare the nodes visited by an enumeration of dimension `n` with the cost predicted by
+   the pruner, in total and at the middle level.
+
+   @param n
+   @return
+*/
+
+int test_enum_cost(int n)
+{
+  int status = 0;
+  RandGen::init_with_seed(n);
+  ZZ_mat<mpz_t> A(n, n + 1), U;
+  A.gen_intrel(10 * n);
+  bkz_reduction(A, 20);
+  MatGSO<Z_NR<mpz_t>, FP_NR<double>> M(A, U, U, GSO_INT_GRAM);
+  M.update_gso();
+
+  FP_NR<double> radius, root_det = M.get_root_det(0, n);
+  M.get_r(radius, 0, 0);
+  adjust_radius_to_gh_bound(radius, 0, n, root_det, 1.1);
+  vector<double> r;
+  for (int i = 0; i < n; ++i)
+  {
+    FP_NR<double> x;
+    M.get_r(x, i, i);
+    r.push_back(x.get_d());
+  }
+  Pruner<FP_NR<double>> pruner(radius.get_d());
+  pruner.load_basis_shape(r);
+  vector<double> detailed_cost;
+  double cost = pruner.single_enum_cost(vector<double>(n, 1.0), &detailed_cost);
+
+  FastEvaluator<FP_NR<double>> evaluator;
+  Enumeration<FP_NR<double>> enumobj(M, evaluator);
+  enumobj.set_detailed_stats(true);
+  enumobj.enumerate(0, n, radius, 0);
+  const EnumerationStats &stats = enumobj.get_stats();
+  vector<double> ratios = stats.cost_ratios(detailed_cost);
+
+  status += !(stats.solutions >= 1 && stats.seconds >= 0.0);
+  print_status(status);
+  status += !(enumobj.get_nodes() > cost / 2 && enumobj.get_nodes() < 2 * cost);
+  print_status(status);
+  status += !(ratios[n / 2] > 0.5 && ratios[n / 2] < 2.0);
+  print_status(status);
+  if (status)
+  {
+    cerr << "Enumeration of dimension " << n << ": " << enumobj.get_nodes() << " nodes, "
+         << stats.solutions << " solutions, predicted " << cost << endl;
+  }
+  return status;
+}
+
 int main(int argc, char *argv[])
 {
   int status = 0;
@@ -566,6 +620,11 @@ int main(int argc, char *argv[])
   status += test_auto_prune<FP_NR<double>>(30);
   print_status(status);
 
+  status += test_enum_cost(40);
+  print_status(status);
+  status += test_enum_cost(41);
+  print_status(status);
+
   if (status == 0)
   {
     cerr << "All tests passed." << endl;
@@ -28,7 +28,9 @@ enum Test
 {
   SVP_ENUM,
   DSVP_ENUM,
-  DSVP_REDUCE
+  DSVP_REDUCE,
+  SVP_PARALLEL_ENUM,
+  SVP_BATCH_ENUM
 };
 
 /**
@@ -61,6 +63,101 @@ template <class ZT> void read_vector(vector<Z_NR<ZT>> &b, const char *input_file
   delete is;
 }
 
+/**
+   @brief Read the matrix of `input_filename` into `A` and LLL-reduce it.
+
+   @param A
+   @param input_filename
+   @return
+*/
+
+void read_reduced_matrix(IntMatrix &A, const char *input_filename)
+{
+  read_matrix(A, input_filename);
+  lll_reduction(A);
+}
+
+/**
+   @brief Test if a batch enumeration of several blocks finds the same solutions as one
+   enumeration per block.
+
+   @param A              input lattice
+   @return
+*/
+
+template <class FT, class ZT> int test_batch_enum(ZZ_mat<ZT> &A)
+{
+  IntMatrix u;
+  int d = A.get_rows();
+
+  int status =
+      lll_reduction(A, u, LLL_DEF_DELTA, LLL_DEF_ETA, LM_WRAPPER, FT_DEFAULT, 0, LLL_DEFAULT);
+  if (status != RED_SUCCESS)
+  {
+    cerr << "LLL reduction failed: " << get_red_status_str(status) << endl;
+    return status;
+  }
+
+  IntMatrix empty_mat;
+  MatGSO<Integer, FT> gso(A, empty_mat, empty_mat, GSO_INT_GRAM);
+  gso.update_gso();
+
+  FT radius;
+  vector<EnumerationJob<FT>> jobs;
+  gso.get_r(radius, 0, 0);
+  jobs.emplace_back(0, d, radius);
+  for (int first = 0; first + 10 <= d; first += 2)
+  {
+    gso.get_r(radius, first, first);
+    jobs.emplace_back(first, first + 10, radius);
+  }
+  // dual enumeration, the radius is the squared norm of the last dual vector
+  gso.get_r(radius, 14, 14);
+  radius.div(1.0, radius);
+  jobs.emplace_back(5, 15, radius, 0, vector<enumf>(), true);
+
+  for (unsigned int threads = 1; threads <= 3; threads += 2)
+  {
+    vector<EnumerationJob<FT>> batch_jobs = jobs;
+    BatchEnumeration<FT> batch_enum(gso);
+    batch_enum.set_threads(threads);
+    batch_enum.enumerate(batch_jobs);
+
+    uint64_t nodes = 0;
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+      FastEvaluator<FT> evaluator;
+      Enumeration<FT> enumobj(gso, evaluator);
+      FT dist = jobs[i].maxdist;
+      enumobj.enumerate(jobs[i].first, jobs[i].last, dist, 0, vector<FT>(), vector<enumxt>(),
+                        vector<enumf>(), jobs[i].dual);
+      const FastEvaluator<FT> &batch_evaluator = batch_jobs[i].evaluator;
+      if (evaluator.empty() != batch_evaluator.empty() ||
+          (!evaluator.empty() &&
+           (evaluator.begin()->first != batch_evaluator.begin()->first ||
+            evaluator.begin()->second != batch_evaluator.begin()->second)))
+      {
+        cerr << "Batch enumeration with " << threads << " threads: wrong solution for block ["
+             << jobs[i].first << ", " << jobs[i].last << ")" << endl;
+        return 1;
+      }
+      if (dist != batch_jobs[i].maxdist || enumobj.get_nodes() != batch_jobs[i].nodes)
+      {
+        cerr << "Batch enumeration with " << threads << " threads: wrong radius or node count"
+             << " for block [" << jobs[i].first << ", " << jobs[i].last << ")" << endl;
+        return 1;
+      }
+      nodes += batch_jobs[i].nodes;
+    }
+    if (nodes != batch_enum.get_nodes())
+    {
+      cerr << "Batch enumeration: node counts of the jobs do not add up" << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
 /**
    @brief Test if SVP function returns vector with right norm.
 
@@ -287,6 +384,1013 @@ template <class ZT> int test_dsvp_reduce(ZZ_mat<ZT> &A, IntVect &b)
   return 0;
 }
 
+/**
+   @brief Test if the parallel enumeration finds a vector as short as the serial enumeration.
+
+   @param A              input lattice
+   @param b              shortest vector
+   @return
+*/
+
+template <class FT, class ZT> int test_parallel_enum(ZZ_mat<ZT> &A, IntVect &b)
+{
+  IntMatrix u;
+  int d = A.get_rows();
+
+  int status =
+      lll_reduction(A, u, LLL_DEF_DELTA, LLL_DEF_ETA, LM_WRAPPER, FT_DEFAULT, 0, LLL_DEFAULT);
+  if (status != RED_SUCCESS)
+  {
+    cerr << "LLL reduction failed: " << get_red_status_str(status) << endl;
+    return status;
+  }
+
+  IntMatrix empty_mat;
+  MatGSO<Integer, FT> gso(A, empty_mat, empty_mat, GSO_INT_GRAM);
+  gso.update_gso();
+
+  FT serial_dist, parallel_dist;
+  gso.get_r(serial_dist, 0, 0);
+  parallel_dist = serial_dist;
+
+  FastEvaluator<FT> serial_evaluator, parallel_evaluator;
+  Enumeration<FT> serial_enum(gso, serial_evaluator), parallel_enum(gso, parallel_evaluator);
+  serial_enum.set_detailed_stats(true);
+  parallel_enum.set_detailed_stats(true);
+  parallel_enum.set_threads(4);
+  serial_enum.enumerate(0, d, serial_dist, 0);
+  parallel_enum.enumerate(0, d, parallel_dist, 0);
+
+  if (serial_evaluator.empty() || parallel_evaluator.empty())
+  {
+    cerr << "Parallel enumeration: no solution found" << endl;
+    return 1;
+  }
+  if (serial_evaluator.begin()->first != parallel_evaluator.begin()->first)
+  {
+    cerr << "Parallel enumeration: solution of norm " << parallel_evaluator.begin()->first
+         << " instead of " << serial_evaluator.begin()->first << endl;
+    return 1;
+  }
+
+  IntVect solution, sol_coord(d);
+  for (int i = 0; i < d; i++)
+    sol_coord[i].set_f(parallel_evaluator.begin()->second[i]);
+  vector_matrix_product(solution, sol_coord, A);
+
+  Integer tmp, norm_s, norm_b;
+  for (int i = 0; i < A.get_cols(); i++)
+  {
+    tmp.mul(solution[i], solution[i]);
+    norm_s.add(norm_s, tmp);
+    tmp.mul(b[i], b[i]);
+    norm_b.add(norm_b, tmp);
+  }
+  if (norm_s != norm_b)
+  {
+    cerr << "Parallel enumeration: solution of norm " << norm_s << " instead of " << norm_b
+         << endl;
+    return 1;
+  }
+
+  vector<uint64_t> serial_levels = serial_enum.get_level_nodes(),
+                   parallel_levels = parallel_enum.get_level_nodes();
+  if (serial_levels.size() != (size_t)d || parallel_levels.size() != (size_t)d ||
+      accumulate(serial_levels.begin(), serial_levels.end(), uint64_t(0)) !=
+          serial_enum.get_nodes() ||
+      accumulate(parallel_levels.begin(), parallel_levels.end(), uint64_t(0)) !=
+          parallel_enum.get_nodes())
+  {
+    cerr << "Enumeration: node counts of the levels do not add up" << endl;
+    return 1;
+  }
+
+  // without detailed statistics, the kernel only counts the total number of nodes
+  FastEvaluator<FT> total_evaluator;
+  Enumeration<FT> total_enum(gso, total_evaluator);
+  FT total_dist;
+  gso.get_r(total_dist, 0, 0);
+  total_enum.enumerate(0, d, total_dist, 0);
+  if (total_enum.get_nodes() != serial_enum.get_nodes() || !total_enum.get_level_nodes().empty())
+  {
+    cerr << "Enumeration: " << total_enum.get_nodes() << " nodes without detailed statistics"
+         << " instead of " << serial_enum.get_nodes() << endl;
+    return 1;
+  }
+
+  // with many threads, idle threads take over work from the busy ones
+  FastEvaluator<FT> stealing_evaluator;
+  EnumerationDyn<FT> stealing_enum(gso, stealing_evaluator);
+  stealing_enum.set_threads(16);
+  gso.get_r(parallel_dist, 0, 0);
+  stealing_enum.enumerate(0, d, parallel_dist, 0);
+  if (stealing_evaluator.empty() ||
+      stealing_evaluator.begin()->first != serial_evaluator.begin()->first)
+  {
+    cerr << "Parallel enumeration with 16 threads: wrong solution" << endl;
+    return 1;
+  }
+  uint64_t thread_nodes = 0;
+  for (uint64_t nodes : stealing_enum.get_thread_nodes())
+    thread_nodes += nodes;
+  if (stealing_enum.get_thread_nodes().size() != 16 || thread_nodes != stealing_enum.get_nodes())
+  {
+    cerr << "Parallel enumeration: node counts of the threads do not add up" << endl;
+    return 1;
+  }
+
+  // the workers of the first enumeration are reused by the next one, with fewer threads
+  stealing_enum.set_threads(4);
+  gso.get_r(parallel_dist, 0, 0);
+  stealing_enum.enumerate(0, d, parallel_dist, 0);
+  thread_nodes = 0;
+  for (uint64_t nodes : stealing_enum.get_thread_nodes())
+    thread_nodes += nodes;
+  if (stealing_evaluator.begin()->first != serial_evaluator.begin()->first ||
+      stealing_enum.get_thread_nodes().size() != 4 || thread_nodes != stealing_enum.get_nodes() ||
+      stealing_enum.get_solutions() == 0)
+  {
+    cerr << "Parallel enumeration: wrong result of a second enumeration" << endl;
+    return 1;
+  }
+
+  // pruned enumeration: the paths to the subtrees are pruned too and must not be subtracted from
+  // the node counts
+  vector<double> pruning(d);
+  for (int i = 0; i < d; i++)
+    pruning[i] = 1.0 - 0.99 * i / d;
+  FastEvaluator<FT> pruned_evaluator;
+  Enumeration<FT> pruned_enum(gso, pruned_evaluator);
+  pruned_enum.set_detailed_stats(true);
+  pruned_enum.set_threads(4);
+  gso.get_r(parallel_dist, 0, 0);
+  pruned_enum.enumerate(0, d, parallel_dist, 0, vector<FT>(), vector<enumxt>(), pruning);
+  vector<uint64_t> pruned_levels = pruned_enum.get_level_nodes();
+  bool pruned_counts_ok = pruned_levels.size() == (size_t)d &&
+                          accumulate(pruned_levels.begin(), pruned_levels.end(), uint64_t(0)) ==
+                              pruned_enum.get_nodes();
+  // a count below zero wraps around
+  for (int i = 0; i < d && pruned_counts_ok; i++)
+    pruned_counts_ok = pruned_levels[i] < (uint64_t(1) << 63);
+  if (!pruned_counts_ok)
+  {
+    cerr << "Pruned parallel enumeration: wrong node counts" << endl;
+    return 1;
+  }
+  if (pruned_evaluator.empty())
+  {
+    cerr << "Pruned parallel enumeration: no solution found" << endl;
+    return 1;
+  }
+
+  // thread-safe evaluator, compared to the best solutions found by a serial enumeration
+  FastEvaluator<FT> best_evaluator(5);
+  Enumeration<FT> best_enum(gso, best_evaluator);
+  gso.get_r(serial_dist, 0, 0);
+  best_enum.enumerate(0, d, serial_dist, 0);
+  for (int strategy = EVALSTRATEGY_BEST_N_SOLUTIONS; strategy <= EVALSTRATEGY_FIRST_N_SOLUTIONS;
+       ++strategy)
+  {
+    ConcurrentEvaluator<FT> concurrent_evaluator(5, EvaluatorStrategy(strategy));
+    Enumeration<FT> concurrent_enum(gso, concurrent_evaluator);
+    concurrent_enum.set_threads(8);
+    gso.get_r(parallel_dist, 0, 0);
+    concurrent_enum.enumerate(0, d, parallel_dist, 0);
+    if (concurrent_evaluator.size() != best_evaluator.size())
+    {
+      cerr << "Concurrent evaluator with strategy " << strategy << ": "
+           << concurrent_evaluator.size() << " solutions instead of " << best_evaluator.size()
+           << endl;
+      return 1;
+    }
+    bool same_lengths = true;
+    for (auto it = concurrent_evaluator.begin(), best_it = best_evaluator.begin();
+         it != concurrent_evaluator.end(); ++it, ++best_it)
+      same_lengths &= it->first == best_it->first;
+    if ((strategy == EVALSTRATEGY_BEST_N_SOLUTIONS && !same_lengths) ||
+        (strategy == EVALSTRATEGY_OPPORTUNISTIC_N_SOLUTIONS &&
+         concurrent_evaluator.begin()->first != best_evaluator.begin()->first))
+    {
+      cerr << "Concurrent evaluator with strategy " << strategy << ": wrong solutions" << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/* Evaluator which interrupts the enumeration with an exception at the first solution found once a
+   checkpoint has been written. */
+template <class FT> class InterruptingEvaluator : public PooledEvaluator<FT>
+{
+public:
+  InterruptingEvaluator(const string &checkpoint_file, size_t nr_solutions)
+      : PooledEvaluator<FT>(nr_solutions), checkpoint_file(checkpoint_file)
+  {
+  }
+
+  virtual void eval_raw_sol(const enumxt *new_sol_coord, int dim, const enumf &new_partial_dist,
+                            enumf &max_dist)
+  {
+    if (ifstream(checkpoint_file.c_str()).good())
+      throw runtime_error("enumeration interrupted");
+    PooledEvaluator<FT>::eval_raw_sol(new_sol_coord, dim, new_partial_dist, max_dist);
+  }
+
+private:
+  string checkpoint_file;
+};
+
+/**
+   @brief Test if an enumeration which is interrupted and resumed from its last checkpoint visits
+   the same nodes and finds the same solutions as an enumeration which runs at once, on the
+   LLL-reduced lattice of `input_filename`.
+
+   @param input_filename
+   @return
+*/
+
+template <class FT> int test_checkpoint(const char *input_filename)
+{
+  const char *checkpoint_file = "test_svp_checkpoint.bin";
+  const size_t nr_solutions   = 20;
+  IntMatrix A, empty_mat;
+  read_reduced_matrix(A, input_filename);
+  int d = A.get_rows();
+  MatGSO<Integer, FT> gso(A, empty_mat, empty_mat, GSO_INT_GRAM);
+  gso.update_gso();
+  remove(checkpoint_file);
+
+  FT max_dist;
+  gso.get_r(max_dist, 0, 0);
+  FastEvaluator<FT> evaluator(nr_solutions);
+  Enumeration<FT> enumobj(gso, evaluator);
+  enumobj.enumerate(0, d, max_dist, 0);
+
+  gso.get_r(max_dist, 0, 0);
+  InterruptingEvaluator<FT> interrupted_evaluator(checkpoint_file, nr_solutions);
+  Enumeration<FT> interrupted_enum(gso, interrupted_evaluator);
+  interrupted_enum.set_checkpoint(checkpoint_file, 100);
+  try
+  {
+    interrupted_enum.enumerate(0, d, max_dist, 0);
+    cerr << "Checkpoint: the enumeration was not interrupted" << endl;
+    return 1;
+  }
+  catch (runtime_error &)
+  {
+  }
+
+  gso.get_r(max_dist, 0, 0);
+  FastEvaluator<FT> resumed_evaluator(nr_solutions);
+  Enumeration<FT> resumed_enum(gso, resumed_evaluator);
+  resumed_enum.set_checkpoint(checkpoint_file, 100, true);
+  resumed_enum.enumerate(0, d, max_dist, 0);
+
+  if (resumed_enum.get_nodes() != enumobj.get_nodes())
+  {
+    cerr << "Checkpoint: " << resumed_enum.get_nodes() << " nodes instead of "
+         << enumobj.get_nodes() << endl;
+    return 1;
+  }
+  if (resumed_evaluator.size() != evaluator.size())
+  {
+    cerr << "Checkpoint: " << resumed_evaluator.size() << " solutions instead of "
+         << evaluator.size() << endl;
+    return 1;
+  }
+  for (auto it = evaluator.begin(), it2 = resumed_evaluator.begin(); it != evaluator.end();
+       ++it, ++it2)
+  {
+    if (it->first != it2->first)
+    {
+      cerr << "Checkpoint: solution of norm " << it2->first << " instead of " << it->first << endl;
+      return 1;
+    }
+  }
+  if (ifstream(checkpoint_file).good())
+  {
+    cerr << "Checkpoint: the checkpoint file was not removed" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+/* FastEvaluator which counts the solutions given to eval_sol. */
+template <class FT> class CountingEvaluator : public FastEvaluator<FT>
+{
+public:
+  CountingEvaluator(size_t nr_solutions) : FastEvaluator<FT>(nr_solutions), calls(0) {}
+
+  virtual void eval_sol(const vector<FT> &new_sol_coord, const enumf &new_partial_dist,
+                        enumf &max_dist)
+  {
+    ++calls;
+    FastEvaluator<FT>::eval_sol(new_sol_coord, new_partial_dist, max_dist);
+  }
+
+  uint64_t calls;
+};
+
+/**
+   @brief Test if a subclass of FastEvaluator which overrides eval_sol receives every solution of
+   the enumeration of the LLL-reduced lattice of `input_filename`, and keeps the same solutions as
+   PooledEvaluator.
+
+   @param input_filename
+   @return
+*/
+
+template <class FT> int test_eval_sol_override(const char *input_filename)
+{
+  const size_t nr_solutions = 5;
+  IntMatrix A, empty_mat;
+  read_reduced_matrix(A, input_filename);
+  int d = A.get_rows();
+  MatGSO<Integer, FT> gso(A, empty_mat, empty_mat, GSO_INT_GRAM);
+  gso.update_gso();
+
+  FT max_dist;
+  gso.get_r(max_dist, 0, 0);
+  CountingEvaluator<FT> evaluator(nr_solutions);
+  Enumeration<FT> enumobj(gso, evaluator);
+  enumobj.enumerate(0, d, max_dist, 0);
+
+  gso.get_r(max_dist, 0, 0);
+  PooledEvaluator<FT> pooled_evaluator(nr_solutions);
+  Enumeration<FT> pooled_enum(gso, pooled_evaluator);
+  pooled_enum.enumerate(0, d, max_dist, 0);
+
+  if (evaluator.calls == 0 || evaluator.calls != evaluator.sol_count)
+  {
+    cerr << "eval_sol override: " << evaluator.calls << " calls for " << evaluator.sol_count
+         << " solutions" << endl;
+    return 1;
+  }
+  if (evaluator.size() != pooled_evaluator.size())
+  {
+    cerr << "eval_sol override: " << evaluator.size() << " solutions instead of "
+         << pooled_evaluator.size() << endl;
+    return 1;
+  }
+  for (auto it = evaluator.begin(), it2 = pooled_evaluator.begin(); it != evaluator.end();
+       ++it, ++it2)
+  {
+    if (it->first != it2->first)
+    {
+      cerr << "eval_sol override: solution of norm " << it->first << " instead of " << it2->first
+           << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+   @brief Test if the subsolutions kept in the table of PooledEvaluator are the same as those given
+   to eval_sub_sol of FastEvaluator, and if their lengths are the norms of the projections of the
+   subsolutions, in the LLL-reduced lattice of `input_filename`.
+
+   @param input_filename
+   @return
+*/
+
+template <class FT> int test_subsolutions(const char *input_filename)
+{
+  IntMatrix A, empty_mat;
+  read_reduced_matrix(A, input_filename);
+  int d = A.get_rows();
+  MatGSO<Integer, FT> gso(A, empty_mat, empty_mat, GSO_INT_GRAM);
+  gso.update_gso();
+
+  FT max_dist;
+  gso.get_r(max_dist, 0, 0);
+  PooledEvaluator<FT> evaluator(1, EVALSTRATEGY_BEST_N_SOLUTIONS, true);
+  Enumeration<FT> enumobj(gso, evaluator);
+  enumobj.enumerate(0, d, max_dist, 0);
+
+  gso.get_r(max_dist, 0, 0);
+  FastEvaluator<FT> vector_evaluator(1, EVALSTRATEGY_BEST_N_SOLUTIONS, true);
+  Enumeration<FT> vector_enum(gso, vector_evaluator);
+  vector_enum.enumerate(0, d, max_dist, 0);
+
+  if (evaluator.sub_solutions.size() != static_cast<size_t>(d) ||
+      vector_evaluator.sub_solutions.size() != static_cast<size_t>(d))
+  {
+    cerr << "Subsolutions: " << evaluator.sub_solutions.size() << " and "
+         << vector_evaluator.sub_solutions.size() << " subsolutions instead of " << d << endl;
+    return 1;
+  }
+  for (int offset = 0; offset < d; ++offset)
+  {
+    const auto &sub_sol = evaluator.sub_solutions[offset];
+    if (sub_sol.first != vector_evaluator.sub_solutions[offset].first ||
+        sub_sol.second != vector_evaluator.sub_solutions[offset].second)
+    {
+      cerr << "Subsolutions: different subsolutions at offset " << offset << endl;
+      return 1;
+    }
+    // norm of the projection orthogonally to b_0, ..., b_(offset - 1)
+    FT norm = 0.0, coord, mu, r;
+    for (int j = offset; j < d; ++j)
+    {
+      coord = sub_sol.second[j];
+      for (int i = j + 1; i < d; ++i)
+      {
+        gso.get_mu(mu, i, j);
+        coord.addmul(sub_sol.second[i], mu);
+      }
+      gso.get_r(r, j, j);
+      coord.mul(coord, coord);
+      norm.addmul(coord, r);
+    }
+    if (abs(norm.get_d() - sub_sol.first.get_d()) > 1e-6 * norm.get_d())
+    {
+      cerr << "Subsolutions: length " << sub_sol.first << " instead of " << norm << " at offset "
+           << offset << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/* squared norm of the vector of L(A) with coordinates coords */
+static void coord_sqr_norm(Integer &norm, const IntVect &coords, IntMatrix &A)
+{
+  IntVect v;
+  vector_matrix_product(v, coords, A);
+  norm = 0;
+  for (const Integer &x : v)
+    norm.addmul(x, x);
+}
+
+/**
+   @brief Test the extreme pruning driver on the LLL-reduced lattice of `input_filename`: it must
+   find a vector as short as the shortest vector with a pruning of success probability 20% in at
+   most 100 trials, and an enumeration with its stop flag set must stop before the end of the
+   same enumeration without it.
+
+   @param input_filename
+   @param threads          number of threads of the driver
+   @return
+*/
+
+int test_extreme_pruning(const char *input_filename, unsigned int threads)
+{
+  const int max_trials = 100;
+  IntMatrix A, empty_mat;
+  read_reduced_matrix(A, input_filename);
+  int d = A.get_rows();
+  MatGSO<Integer, FP_NR<double>> gso(A, empty_mat, empty_mat, GSO_INT_GRAM);
+  gso.update_gso();
+
+  IntVect sol_coord;
+  Integer norm;
+  shortest_vector(A, sol_coord);
+  coord_sqr_norm(norm, sol_coord, A);
+  double radius = norm.get_d() * 1.01;
+
+  // pruning with a success probability of 20%
+  vector<double> r(d);
+  FP_NR<double> r_ii;
+  for (int i = 0; i < d; i++)
+  {
+    gso.get_r(r_ii, i, i);
+    r[i] = r_ii.get_d();
+  }
+  Pruning pruning_param;
+  double pruning_radius = radius;
+  prune<FP_NR<double>>(pruning_param, pruning_radius, 1e4, 0.2, r);
+  const vector<double> &pruning = pruning_param.coefficients;
+
+  ExtremePruningStats stats;
+  int status = shortest_vector_extreme_pruning(A, sol_coord, radius, pruning, max_trials, threads,
+                                               &stats);
+  if (status != RED_SUCCESS)
+  {
+    cerr << "Extreme pruning: no vector found in " << stats.trials << " trials" << endl;
+    return 1;
+  }
+  coord_sqr_norm(norm, sol_coord, A);
+  if (norm.get_d() > radius || norm.sgn() == 0)
+  {
+    cerr << "Extreme pruning: vector of squared norm " << norm << " instead of " << radius << endl;
+    return 1;
+  }
+  if (stats.successes < 1 || stats.trials + stats.stopped > max_trials ||
+      stats.probability != svp_probability<FP_NR<double>>(pruning).get_d())
+  {
+    cerr << "Extreme pruning: wrong statistics" << endl;
+    return 1;
+  }
+
+  std::atomic<bool> stop(true);
+  uint64_t nodes[2];
+  for (int i = 0; i < 2; i++)
+  {
+    FP_NR<double> max_dist;
+    gso.get_r(max_dist, 0, 0);
+    FastEvaluator<FP_NR<double>> evaluator;
+    Enumeration<FP_NR<double>> enumobj(gso, evaluator);
+    if (i == 1)
+      enumobj.set_stop_flag(&stop);
+    enumobj.enumerate(0, d, max_dist, 0);
+    nodes[i] = enumobj.get_nodes();
+  }
+  if (nodes[1] >= nodes[0])
+  {
+    cerr << "Extreme pruning: " << nodes[1] << " nodes after the stop, " << nodes[0]
+         << " without it" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+   @brief Test the mixed-precision enumeration on the LLL-reduced lattice of `input_filename`:
+   with all levels in float, the 10 shortest vectors found and their lengths must be those of the
+   enumeration in double.
+
+   @param input_filename
+   @param threads          number of threads of the enumeration
+   @return
+*/
+
+int test_float_levels(const char *input_filename, unsigned int threads)
+{
+  const int nr_sol = 10;
+  IntMatrix A, empty_mat;
+  read_reduced_matrix(A, input_filename);
+  int d = A.get_rows();
+  MatGSO<Integer, FP_NR<double>> gso(A, empty_mat, empty_mat, GSO_INT_GRAM);
+  gso.update_gso();
+
+  vector<double> dists[2];
+  vector<Integer> norms[2];
+  for (int i = 0; i < 2; i++)
+  {
+    FP_NR<double> max_dist;
+    gso.get_r(max_dist, 0, 0);
+    FastEvaluator<FP_NR<double>> evaluator(nr_sol, EVALSTRATEGY_BEST_N_SOLUTIONS);
+    Enumeration<FP_NR<double>> enumobj(gso, evaluator);
+    enumobj.set_threads(threads);
+    enumobj.set_float_levels(i ? d : 0);
+    enumobj.enumerate(0, d, max_dist, 0);
+    for (const auto &sol : evaluator)
+    {
+      IntVect coords(d);
+      for (int j = 0; j < d; j++)
+        coords[j] = sol.second[j].get_si();
+      Integer norm;
+      coord_sqr_norm(norm, coords, A);
+      dists[i].push_back(sol.first.get_d());
+      norms[i].push_back(norm);
+    }
+  }
+
+  if (dists[1].size() != static_cast<size_t>(nr_sol) || norms[1] != norms[0])
+  {
+    cerr << "Float levels: " << dists[1].size() << " solutions different from the "
+         << dists[0].size() << " solutions in double" << endl;
+    return 1;
+  }
+  for (int j = 0; j < nr_sol; j++)
+  {
+    if (abs(dists[1][j] - norms[1][j].get_d()) > 1e-9 * norms[1][j].get_d())
+    {
+      cerr << "Float levels: length " << dists[1][j] << " instead of " << norms[1][j] << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+   @brief Test if the enumeration kernel compiled for AVX2 finds the same solutions as the generic
+   kernel on the LLL-reduced lattice of `input_filename`, for a primal enumeration in double, with
+   all levels in float, and for a dual enumeration. FMA may round the centers differently, so that
+   the lengths are compared up to rounding and the node counts are not compared. Nothing is
+   compared if the CPU does not support the AVX2 kernel or if it is not compiled.
+
+   @param input_filename
+   @return
+*/
+
+int test_avx2_kernel(const char *input_filename)
+{
+  IntMatrix A, empty_mat;
+  read_reduced_matrix(A, input_filename);
+  int d = A.get_rows();
+  MatGSO<Integer, FP_NR<double>> gso(A, empty_mat, empty_mat, GSO_INT_GRAM);
+  gso.update_gso();
+  if (!set_enum_avx2_kernel(true))
+    return 0;
+
+  int status = 0;
+  const char *names[] = {"primal", "float levels", "dual"};
+  for (int test = 0; test < 3 && status == 0; test++)
+  {
+    bool dual = test == 2;
+    vector<vector<long>> coords[2];
+    vector<double> dists[2];
+    for (int i = 0; i < 2; i++)
+    {
+      set_enum_avx2_kernel(i == 1);
+      FP_NR<double> max_dist;
+      gso.get_r(max_dist, dual ? d - 1 : 0, dual ? d - 1 : 0);
+      if (dual)
+        max_dist.div(1.0, max_dist);
+      FastEvaluator<FP_NR<double>> evaluator(10);
+      Enumeration<FP_NR<double>> enumobj(gso, evaluator);
+      enumobj.set_float_levels(test == 1 ? d : 0);
+      enumobj.enumerate(0, d, max_dist, 0, vector<FP_NR<double>>(), vector<enumxt>(),
+                        vector<enumf>(), dual);
+      for (const auto &sol : evaluator)
+      {
+        coords[i].emplace_back();
+        for (const auto &x : sol.second)
+          coords[i].back().push_back(x.get_si());
+        dists[i].push_back(sol.first.get_d());
+      }
+    }
+    if (coords[0].empty() || coords[1] != coords[0])
+    {
+      cerr << "AVX2 kernel, " << names[test] << ": " << coords[1].size()
+           << " solutions different from the " << coords[0].size() << " of the generic kernel"
+           << endl;
+      status = 1;
+    }
+    for (size_t j = 0; j < dists[0].size() && status == 0; j++)
+    {
+      if (abs(dists[1][j] - dists[0][j]) > 1e-9 * dists[0][j])
+      {
+        cerr << "AVX2 kernel, " << names[test] << ": length " << dists[1][j] << " instead of "
+             << dists[0][j] << endl;
+        status = 1;
+      }
+    }
+  }
+  set_enum_avx2_kernel(true);
+  return status;
+}
+
+/**
+   @brief Test the batched verification of ExactErrorBoundedEvaluator on the LLL-reduced lattice
+   of `input_filename`: with batches of 4 candidates, verified in place or by a separate thread,
+   the evaluator must keep the same solutions as when each candidate is verified when it is found,
+   and shortest_vector() with SVP_BATCH_VERIFY must find a shortest vector.
+
+   @param input_filename
+   @return
+*/
+
+int test_batch_verify(const char *input_filename)
+{
+  const int nr_sol = 3;
+  IntMatrix A, empty_mat;
+  read_reduced_matrix(A, input_filename);
+  int d = A.get_rows();
+  double rho;
+  int prec     = max(53, gso_min_prec(rho, d, LLL_DEF_DELTA, LLL_DEF_ETA) + 10);
+  int old_prec = Float::set_prec(prec);
+  MatGSO<Integer, Float> gso(A, empty_mat, empty_mat, GSO_INT_GRAM);
+  gso.update_gso();
+
+  vector<Float> dists[3];
+  for (int i = 0; i < 3; i++)
+  {
+    Float max_dist;
+    gso.get_r(max_dist, 0, 0);
+    ExactErrorBoundedEvaluator evaluator(d, A, gso.get_mu_matrix(), gso.get_r_matrix(),
+                                         EVALMODE_SV, nr_sol);
+    evaluator.init_delta_def(prec, rho, true);
+    if (i > 0)
+      evaluator.set_batch(4, i == 2);
+    Enumeration<Float> enumobj(gso, evaluator);
+    enumobj.enumerate(0, d, max_dist, 0);
+    for (const auto &sol : evaluator)
+      dists[i].push_back(sol.first);
+  }
+  Float::set_prec(old_prec);
+
+  for (int i = 1; i < 3; i++)
+  {
+    if (dists[0].empty() || dists[i].size() != dists[0].size())
+    {
+      cerr << "Batch verification: " << dists[i].size() << " solutions instead of "
+           << dists[0].size() << endl;
+      return 1;
+    }
+    for (size_t j = 0; j < dists[0].size(); j++)
+    {
+      if (dists[i][j] != dists[0][j])
+      {
+        cerr << "Batch verification: length " << dists[i][j] << " instead of " << dists[0][j]
+             << endl;
+        return 1;
+      }
+    }
+  }
+
+  IntVect sol_coord[2];
+  Integer norm[2];
+  for (int i = 0; i < 2; i++)
+  {
+    shortest_vector(A, sol_coord[i], SVPM_PROVED, i ? SVP_BATCH_VERIFY : SVP_DEFAULT);
+    coord_sqr_norm(norm[i], sol_coord[i], A);
+  }
+  if (norm[1] != norm[0])
+  {
+    cerr << "Batch verification: squared norm " << norm[1] << " instead of " << norm[0] << endl;
+    return 1;
+  }
+  return 0;
+}
+
+/* Number of calls to naive_enumerate(). */
+static int naive_enumerate_calls = 0;
+
+/* Primal enumeration without pruning nor subsolutions, for the registry of external enumerators:
+   the coordinates of each level are taken in increasing order, the first nonzero one being
+   positive. The number of nodes it returns is multiplied by scale, to be measured faster than the
+   other backends by benchmark_external_enumerators(). */
+uint64_t naive_enumerate(uint64_t scale, int dim, enumf maxdist,
+                         std::function<extenum_cb_set_config> cbfunc,
+                         std::function<extenum_cb_process_sol> cbsol,
+                         std::function<extenum_cb_process_subsol>, bool dual, bool findsubsols)
+{
+  ++naive_enumerate_calls;
+  if (dual || findsubsols)
+    return ~uint64_t(0);
+  vector<enumf> mut(dim * dim), rdiag(dim), pruning(dim), x(dim, 0.0);
+  cbfunc(&mut[0], dim, true, &rdiag[0], &pruning[0]);
+
+  uint64_t nodes = 0;
+  function<void(int, enumf, bool)> enumerate_level = [&](int k, enumf partdist, bool zero) {
+    enumf center = 0.0;
+    for (int j = k + 1; j < dim; j++)
+      center -= x[j] * mut[k * dim + j];
+    enumf radius = sqrt(max(maxdist - partdist, 0.0) / rdiag[k]);
+    for (x[k] = max(ceil(center - radius), zero ? 0.0 : -HUGE_VAL); x[k] <= center + radius;
+         x[k] += 1.0)
+    {
+      enumf dist = partdist + (x[k] - center) * (x[k] - center) * rdiag[k];
+      if (!(dist <= maxdist))
+        continue;
+      nodes++;
+      if (k > 0)
+        enumerate_level(k - 1, dist, zero && x[k] == 0.0);
+      else if (!(zero && x[k] == 0.0))
+        maxdist = cbsol(dist, &x[0]);
+      radius = sqrt(max(maxdist - partdist, 0.0) / rdiag[k]);
+    }
+    x[k] = 0.0;
+  };
+  enumerate_level(dim - 1, 0.0, true);
+  return nodes * scale;
+}
+
+/* Enumerates the shortest vector of A: returns its squared length, -1 if none is found, and sets
+   backend to the external enumerator which found it, empty for fplll's own enumeration. */
+static double enumerate_shortest(IntMatrix &A, string &backend)
+{
+  IntMatrix empty_mat;
+  MatGSO<Integer, FP_NR<double>> gso(A, empty_mat, empty_mat, GSO_INT_GRAM);
+  gso.update_gso();
+  FP_NR<double> max_dist;
+  gso.get_r(max_dist, 0, 0);
+  FastEvaluator<FP_NR<double>> evaluator;
+  Enumeration<FP_NR<double>> enumobj(gso, evaluator);
+  enumobj.enumerate(0, A.get_rows(), max_dist, 0);
+  backend = enumobj.get_stats().backend;
+  return evaluator.empty() ? -1.0 : evaluator.begin()->first.get_d();
+}
+
+/**
+   @brief Test the registry of external enumerators on the LLL-reduced lattice of
+   `input_filename`: the enumeration must be given to the backend of highest priority accepting
+   it, the speed measured by benchmark_external_enumerators() breaking the ties, the default
+   backend of set_external_enumerator() must always be used, and all of them must find the same
+   shortest vector as fplll's own enumeration. Registering a backend must not run it.
+
+   @param input_filename
+   @return
+*/
+
+int test_external_enumerators(const char *input_filename)
+{
+  using namespace std::placeholders;
+  IntMatrix A;
+  read_matrix(A, input_filename);
+  lll_reduction(A);
+  int d = A.get_rows();
+
+  int status = 0;
+  string backend;
+  double dist = enumerate_shortest(A, backend);
+
+  register_external_enumerator("low", bind(naive_enumerate, 1, _1, _2, _3, _4, _5, _6, _7), 0, 1,
+                               d, false, false);
+  register_external_enumerator("high", bind(naive_enumerate, 1, _1, _2, _3, _4, _5, _6, _7), 1, 1,
+                               d, false, false);
+  register_external_enumerator("fast", bind(naive_enumerate, 1000000, _1, _2, _3, _4, _5, _6, _7),
+                               1, 1, d, false, false);
+  register_external_enumerator("unsupported", [](int, enumf, function<extenum_cb_set_config>,
+                                                 function<extenum_cb_process_sol>,
+                                                 function<extenum_cb_process_subsol>, bool,
+                                                 bool) { return ~uint64_t(0); },
+                               2, 1, d, false, true);
+  if (naive_enumerate_calls != 0)
+  {
+    cerr << "External enumerators: backend run at its registration" << endl;
+    status = 1;
+  }
+  if (!has_external_enumerator(d) || has_external_enumerator(d, true) ||
+      !has_external_enumerator(d, false, true) || has_external_enumerator(d + 1))
+  {
+    cerr << "External enumerators: wrong capabilities" << endl;
+    status = 1;
+  }
+
+  // "unsupported" is tried first, then "high" and "fast" of the same priority, in the order of
+  // their registration until "fast" is measured faster than "high"
+  string backends[] = {"high", EXTENUM_DEFAULT_BACKEND, "fast", "low", ""};
+  for (int i = 0; i < 5; i++)
+  {
+    if (i == 1)
+      set_external_enumerator(bind(naive_enumerate, 1, _1, _2, _3, _4, _5, _6, _7));
+    if (i == 2)
+    {
+      set_external_enumerator();
+      benchmark_external_enumerators(d, d);
+    }
+    if (i == 3)
+      register_external_enumerator("low", bind(naive_enumerate, 1, _1, _2, _3, _4, _5, _6, _7), 3,
+                                   1, d, false, false);
+    if (i == 4)
+    {
+      for (const ExternalEnumerator &registered : get_external_enumerators())
+        register_external_enumerator(registered.name, nullptr);
+    }
+    double backend_dist = enumerate_shortest(A, backend);
+    if (backend != backends[i])
+    {
+      cerr << "External enumerators: enumeration by '" << backend << "' instead of '"
+           << backends[i] << "'" << endl;
+      status = 1;
+    }
+    if (abs(backend_dist - dist) > 1e-9 * dist)
+    {
+      cerr << "External enumerators: length " << backend_dist << " instead of " << dist << endl;
+      status = 1;
+    }
+  }
+  if (!get_external_enumerators().empty() || get_external_enumerator() != nullptr)
+  {
+    cerr << "External enumerators: backends left in the registry" << endl;
+    status = 1;
+  }
+  return status;
+}
+
+/**
+   @brief Test the dual GSO kept by the enumeration between dual enumerations of the block [10, 30)
+   of the LLL-reduced lattice of `input_filename`, of dimension at least 36: after operations on
+   rows after the block, on its last row, inside it and on rows before it, the enumeration must
+   find the same shortest dual vector as a new enumeration object, and the stamp of the block must
+   change only in the second and third cases. A shorter block starting at the same row replaces it
+   in the cache, and is replaced again by the first one.
+
+   @param input_filename
+   @return
+*/
+
+int test_dual_gso_cache(const char *input_filename)
+{
+  const int first = 10, last = 30;
+  IntMatrix A, empty_mat;
+  read_reduced_matrix(A, input_filename);
+  MatGSO<Integer, FP_NR<double>> gso(A, empty_mat, empty_mat, GSO_INT_GRAM);
+  gso.update_gso();
+  FastEvaluator<FP_NR<double>> cached_evaluator;
+  Enumeration<FP_NR<double>> cached_enum(gso, cached_evaluator);
+
+  int status = 0;
+  for (int step = 0; step < 7; step++)
+  {
+    int end    = step == 5 ? last - 5 : last;
+    long stamp = gso.get_row_op_stamp(first, last);
+    if (step == 1 || step == 2 || step == 4)
+    {
+      int row = step == 1 ? last + 5 : step == 2 ? last - 1 : first - 5;
+      gso.row_op_begin(row, row + 1);
+      gso.row_addmul(row, first - 7, FP_NR<double>(1.0));
+      gso.row_op_end(row, row + 1);
+    }
+    else if (step == 3)
+      gso.move_row(last - 5, first + 2);
+    if ((gso.get_row_op_stamp(first, last) != stamp) != (step == 2 || step == 3))
+    {
+      cerr << "Dual GSO cache: wrong stamp after step " << step << endl;
+      status = 1;
+    }
+    gso.update_gso();
+
+    vector<long> coords[2];
+    double dists[2];
+    for (int i = 0; i < 2; i++)
+    {
+      FP_NR<double> max_dist;
+      gso.get_r(max_dist, end - 1, end - 1);
+      max_dist = 1.01 / max_dist.get_d();
+      FastEvaluator<FP_NR<double>> new_evaluator;
+      FastEvaluator<FP_NR<double>> &evaluator = i ? new_evaluator : cached_evaluator;
+      evaluator.solutions.clear();
+      Enumeration<FP_NR<double>> new_enum(gso, new_evaluator);
+      (i ? new_enum : cached_enum)
+          .enumerate(first, end, max_dist, 0, vector<FP_NR<double>>(), vector<enumxt>(),
+                     vector<enumf>(), true);
+      dists[i] = evaluator.empty() ? -1.0 : evaluator.begin()->first.get_d();
+      if (!evaluator.empty())
+        for (const auto &x : evaluator.begin()->second)
+          coords[i].push_back(x.get_si());
+    }
+    if (dists[1] < 0.0 || coords[0] != coords[1] ||
+        abs(dists[0] - dists[1]) > 1e-9 * dists[1])
+    {
+      cerr << "Dual GSO cache: dual vector of length " << dists[0] << " instead of " << dists[1]
+           << " after step " << step << endl;
+      status = 1;
+    }
+  }
+  return status;
+}
+
+/**
+   @brief Test the double shadow of the GSO with row exponents on the LLL-reduced lattice of
+   `input_filename`, of dimension at least 35: after row operations and moves, the primal and dual
+   enumerations of the block [5, 35) must visit the same nodes and find the same vectors as with a
+   GSO without shadow.
+
+   @param input_filename
+   @return
+*/
+
+int test_double_shadow(const char *input_filename)
+{
+  const int first = 5, last = 35;
+  IntMatrix A[2], empty_mat;
+  read_reduced_matrix(A[0], input_filename);
+  A[1] = A[0];
+  MatGSO<Integer, FP_NR<double>> gso0(A[0], empty_mat, empty_mat, GSO_ROW_EXPO);
+  MatGSO<Integer, FP_NR<double>> gso1(A[1], empty_mat, empty_mat,
+                                      GSO_ROW_EXPO | GSO_DOUBLE_SHADOW);
+  MatGSO<Integer, FP_NR<double>> *gso[2] = {&gso0, &gso1};
+
+  int status = 0;
+  for (int step = 0; step < 3; step++)
+  {
+    uint64_t nodes[2][2];
+    double dists[2][2];
+    for (int i = 0; i < 2; i++)
+    {
+      if (step == 1)
+      {
+        gso[i]->row_op_begin(first + 10, first + 11);
+        gso[i]->row_addmul(first + 10, 2, FP_NR<double>(3.0));
+        gso[i]->row_op_end(first + 10, first + 11);
+      }
+      else if (step == 2)
+        gso[i]->move_row(last - 3, first + 4);
+      gso[i]->update_gso();
+
+      for (int dual = 0; dual < 2; dual++)
+      {
+        FP_NR<double> max_dist;
+        gso[i]->get_r(max_dist, dual ? last - 1 : first, dual ? last - 1 : first);
+        if (dual)
+          max_dist = 1.0 / max_dist.get_d();
+        FastEvaluator<FP_NR<double>> evaluator;
+        Enumeration<FP_NR<double>> enumobj(*gso[i], evaluator);
+        enumobj.enumerate(first, last, max_dist, 0, vector<FP_NR<double>>(), vector<enumxt>(),
+                          vector<enumf>(), dual);
+        nodes[i][dual] = enumobj.get_nodes();
+        dists[i][dual] = evaluator.empty() ? -1.0 : evaluator.begin()->first.get_d();
+      }
+    }
+    for (int dual = 0; dual < 2; dual++)
+    {
+      if (nodes[1][dual] != nodes[0][dual] || dists[1][dual] != dists[0][dual])
+      {
+        cerr << "Double shadow: " << nodes[1][dual] << " nodes and length " << dists[1][dual]
+             << " instead of " << nodes[0][dual] << " and " << dists[0][dual] << " after step "
+             << step << (dual ? " (dual)" : "") << endl;
+        status = 1;
+      }
+    }
+  }
+  return status;
+}
+
 /**
    @brief Test if SVP function returns vector with right norm.
 
@@ -313,6 +1417,11 @@ int test_filename(const char *input_filename, const char *output_filename,
     return test_dual_svp<ZT>(A, b);
   case DSVP_REDUCE:
     return test_dsvp_reduce<ZT>(A, b);
+  case SVP_PARALLEL_ENUM:
+    return test_parallel_enum<FP_NR<double>, ZT>(A, b) |
+           test_parallel_enum<FP_NR<mpfr_t>, ZT>(A, b);
+  case SVP_BATCH_ENUM:
+    return test_batch_enum<FP_NR<double>, ZT>(A) | test_batch_enum<FP_NR<mpfr_t>, ZT>(A);
   }
 
   cerr << "Unknown test." << endl;
@@ -337,6 +1446,25 @@ int main(int argc, char *argv[])
                                  TESTDATADIR "/tests/lattices/example_dsvp_out", DSVP_ENUM);
   status |= test_filename<mpz_t>(TESTDATADIR "/tests/lattices/example_dsvp_in",
                                  TESTDATADIR "/tests/lattices/example_dsvp_out", DSVP_REDUCE);
+  status |= test_filename<mpz_t>(TESTDATADIR "/tests/lattices/example_svp_in",
+                                 TESTDATADIR "/tests/lattices/example_svp_out", SVP_PARALLEL_ENUM);
+  status |= test_filename<mpz_t>(TESTDATADIR "/tests/lattices/example_svp_in",
+                                 TESTDATADIR "/tests/lattices/example_svp_out", SVP_BATCH_ENUM);
+  status |= test_checkpoint<FP_NR<double>>(TESTDATADIR "/tests/lattices/example_dsvp_in");
+  status |= test_checkpoint<FP_NR<mpfr_t>>(TESTDATADIR "/tests/lattices/example_dsvp_in");
+  status |= test_eval_sol_override<FP_NR<double>>(TESTDATADIR "/tests/lattices/example_svp_in");
+  status |= test_eval_sol_override<FP_NR<mpfr_t>>(TESTDATADIR "/tests/lattices/example_svp_in");
+  status |= test_subsolutions<FP_NR<double>>(TESTDATADIR "/tests/lattices/example_svp_in");
+  status |= test_subsolutions<FP_NR<mpfr_t>>(TESTDATADIR "/tests/lattices/example_svp_in");
+  status |= test_extreme_pruning(TESTDATADIR "/tests/lattices/example_dsvp_in", 1);
+  status |= test_extreme_pruning(TESTDATADIR "/tests/lattices/example_dsvp_in", 3);
+  status |= test_float_levels(TESTDATADIR "/tests/lattices/example_dsvp_in", 1);
+  status |= test_float_levels(TESTDATADIR "/tests/lattices/example_dsvp_in", 3);
+  status |= test_avx2_kernel(TESTDATADIR "/tests/lattices/example_dsvp_in");
+  status |= test_batch_verify(TESTDATADIR "/tests/lattices/example_svp_in");
+  status |= test_external_enumerators(TESTDATADIR "/tests/lattices/example_svp_in");
+  status |= test_dual_gso_cache(TESTDATADIR "/tests/lattices/example_dsvp_in");
+  status |= test_double_shadow(TESTDATADIR "/tests/lattices/dim55_in");
 
   if (status == 0)
   {